@@ -0,0 +1,168 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <tuple>
+#include <type_traits>
+
+// atomic_named_tuple - named values shared between threads without a lock,
+// each field stored as a std::atomic of its value type:
+//
+//   nvt::atomic_named_tuple<nvt::named_value<uint64_t, decltype("hits"_)>,
+//                           nvt::named_value<bool, decltype("live"_)>> st;
+//   st.fetch_add<"hits"_>(1, std::memory_order_relaxed);
+//   if (st.load<"live"_>()) ...
+//
+// Field types must be trivially copyable and always lock free atomics.
+
+namespace nvtuple_ns {
+
+template<typename VT>
+struct is_always_lock_free
+    : std::bool_constant<std::atomic<VT>::is_always_lock_free> {};
+
+template<typename VT>
+struct is_atomic_field
+    : std::conjunction<std::is_trivially_copyable<VT>,
+                       is_always_lock_free<VT>> {};
+
+template<typename VT>
+constexpr bool is_atomic_field_v = is_atomic_field<VT>::value;
+
+template<typename... TS>
+class atomic_named_tuple {
+   public:
+    using tuple_type = named_tuple<TS...>;
+
+    static_assert((... && is_atomic_field_v<typename TS::type>),
+                  "atomic_named_tuple fields must be trivially copyable, "
+                  "lock free atomic types");
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    template<typename T>
+    using value_type_of = typename std::tuple_element_t<
+        get_index<T>(), std::tuple<TS...>>::type;
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            TS::get_value_name()...};
+    }
+
+    atomic_named_tuple() noexcept = default;
+    explicit atomic_named_tuple(const tuple_type& t) noexcept {
+        (..., get<typename TS::namedtype>().store(
+                  t[typename TS::namedtype{}].get(),
+                  std::memory_order_relaxed));
+    }
+
+    atomic_named_tuple(const atomic_named_tuple&) = delete;
+    atomic_named_tuple& operator=(const atomic_named_tuple&) = delete;
+
+    // the std::atomic of a field
+    template<typename T>
+    std::atomic<value_type_of<T>>& get() noexcept {
+        return std::get<get_index<T>()>(_fields);
+    }
+
+    template<typename T>
+    const std::atomic<value_type_of<T>>& get() const noexcept {
+        return std::get<get_index<T>()>(_fields);
+    }
+
+    template<typename T>
+    std::atomic<value_type_of<T>>& operator[](T) noexcept {
+        return get<T>();
+    }
+
+    template<typename T>
+    const std::atomic<value_type_of<T>>& operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    // access by name, ("hits"_ as template argument)
+
+    template<auto N>
+    auto load(std::memory_order order = std::memory_order_seq_cst) const
+        noexcept {
+        return get<typename decltype(N)::type>().load(order);
+    }
+
+    template<auto N, typename V>
+    void store(const V& v,
+               std::memory_order order = std::memory_order_seq_cst) noexcept {
+        get<typename decltype(N)::type>().store(v, order);
+    }
+
+    template<auto N, typename V>
+    auto exchange(
+        const V& v,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return get<typename decltype(N)::type>().exchange(v, order);
+    }
+
+    template<auto N, typename V>
+    auto fetch_add(
+        const V& v,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return get<typename decltype(N)::type>().fetch_add(v, order);
+    }
+
+    template<auto N, typename V>
+    auto fetch_sub(
+        const V& v,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return get<typename decltype(N)::type>().fetch_sub(v, order);
+    }
+
+    // compare_exchange_strong, expected is updated on failure
+    template<auto N>
+    bool compare_exchange(
+        value_type_of<typename decltype(N)::type>& expected,
+        value_type_of<typename decltype(N)::type> desired,
+        std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return get<typename decltype(N)::type>().compare_exchange_strong(
+            expected, desired, order);
+    }
+
+    // a named_tuple copy of the fields, each loaded on its own: the copy is
+    // not a consistent snapshot of concurrent updates of several fields
+    tuple_type snapshot(
+        std::memory_order order = std::memory_order_relaxed) const noexcept {
+        tuple_type t;
+        (..., (t[typename TS::namedtype{}] =
+                   get<typename TS::namedtype>().load(order)));
+        return t;
+    }
+
+   private:
+    std::tuple<std::atomic<typename TS::type>...> _fields{};
+};
+
+// atomic_for<named_tuple<TS...>>::type is atomic_named_tuple<TS...>
+
+template<typename T>
+struct atomic_for;
+
+template<typename... TS>
+struct atomic_for<named_tuple<TS...>> {
+    using type = atomic_named_tuple<TS...>;
+};
+
+template<typename T>
+using atomic_for_t = typename atomic_for<T>::type;
+
+}  // namespace nvtuple_ns
+
+template<typename... TS>
+inline std::ostream& operator<<(
+    std::ostream& os, const nvtuple_ns::atomic_named_tuple<TS...>& t) {
+    return os << t.snapshot();
+}
@@ -0,0 +1,54 @@
+// Benchmark: records per cache line and scan time of 4M book levels stored
+// as named_tuple and as bitpacked_named_tuple (NVT_FIELD_BITS widths).
+
+#include <bitpacked_named_tuple.h>
+#include <named_tuple.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+NVT_FIELD_BITS("side"_, std::uint8_t, 1)
+NVT_FIELD_BITS("qty"_, std::uint32_t, 20)
+NVT_FIELD_BITS("orders"_, std::uint16_t, 10)
+NVT_FIELD_BITS("live"_, bool, 1)
+
+using level_t = nvt::named_tuple<decltype(~"side"_), decltype(~"qty"_),
+                                 decltype(~"orders"_), decltype(~"live"_)>;
+using packed_level_t = nvt::bitpacked_for_t<level_t>;
+
+template<typename Record>
+void scan(const char* label, std::size_t n) {
+    std::vector<Record> records(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        records[i]["side"_] = std::uint8_t(i & 1);
+        records[i]["qty"_] = std::uint32_t(i % 100000);
+        records[i]["orders"_] = std::uint16_t(i % 1000);
+        records[i]["live"_] = (i % 7) != 0;
+    }
+    std::uint64_t total = 0;
+    constexpr int reps = 10;
+    const auto start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < reps; ++rep)
+        for (const auto& r : records)
+            if (r["live"_].get() && r["side"_].get())
+                total += r["qty"_].get() + r["orders"_].get();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::cout << label << ": sizeof " << sizeof(Record) << ", "
+              << 64 / sizeof(Record) << " per cache line, "
+              << double(ns) / double(reps * n) << " ns/record"
+              << " (total " << total << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                   : std::size_t(4) << 20;
+    scan<level_t>("named_tuple          ", n);
+    scan<packed_level_t>("bitpacked_named_tuple", n);
+    return 0;
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+
+// bitpacked_named_tuple - integer, enum and bool fields stored in the least
+// number of bits, declared per field name:
+//
+//   NVT_FIELD_BITS("side"_, std::uint8_t, 2)
+//   NVT_FIELD_BITS("qty"_, std::uint32_t, 20)
+//   nvt::bitpacked_named_tuple<decltype(~"side"_), decltype(~"qty"_)> o;
+//   o["qty"_] = 1000;                   // shift and mask, no branch
+//   std::uint32_t q = o["qty"_];
+//
+// A field without NVT_FIELD_BITS takes the full width of its type (1 bit for
+// bool). The fields are assigned to words first fit, widest first; no field
+// crosses a word boundary, so each access is one load, a shift and a mask.
+// The word type is the smallest unsigned type that holds all the bits, or
+// std::uint64_t. Assigned values are truncated to the field width.
+
+namespace nvtuple_ns {
+
+template<typename FN>  // decltype("abc"_)
+class named_value_bits {
+   public:
+    constexpr const static std::size_t value{0};
+};
+
+namespace bits_detail {
+
+template<typename VT>
+constexpr std::size_t type_bits() noexcept {
+    if constexpr (std::is_same<VT, bool>::value)
+        return 1;
+    else
+        return sizeof(VT) * CHAR_BIT;
+}
+
+template<typename NV>
+constexpr std::size_t field_bits() noexcept {
+    using VT = typename NV::type;
+    static_assert(std::is_integral<VT>::value || std::is_enum<VT>::value,
+                  "bitpacked fields must be integer, enum or bool types");
+    constexpr std::size_t bits =
+        named_value_bits<typename NV::namedtype>::value;
+    static_assert(bits <= type_bits<VT>() && bits <= 64,
+                  "NVT_FIELD_BITS width is larger than the field type");
+    return bits ? bits : type_bits<VT>();
+}
+
+template<std::size_t Bits>
+using word_for_t = std::conditional_t<
+    (Bits <= 8), std::uint8_t,
+    std::conditional_t<
+        (Bits <= 16), std::uint16_t,
+        std::conditional_t<(Bits <= 32), std::uint32_t, std::uint64_t>>>;
+
+struct field_slot {
+    std::size_t word;
+    std::size_t shift;
+};
+
+// first fit decreasing assignment of N fields of the given widths to words
+// of WordBits bits
+template<std::size_t WordBits, std::size_t N>
+constexpr std::array<field_slot, N> assign_slots(
+    const std::array<std::size_t, N>& widths) {
+    // field indices by decreasing width, stable insertion sort
+    std::array<std::size_t, N> order{};
+    for (std::size_t i = 0; i < N; ++i) {
+        std::size_t j = i;
+        for (; j > 0 && widths[order[j - 1]] < widths[i]; --j)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+    std::array<std::size_t, N + 1> used{};
+    std::array<field_slot, N> slots{};
+    for (std::size_t i : order) {
+        std::size_t w = 0;
+        while (used[w] + widths[i] > WordBits) ++w;
+        slots[i] = {w, used[w]};
+        used[w] += widths[i];
+    }
+    return slots;
+}
+
+}  // namespace bits_detail
+
+// bit_ref - a field of a bitpacked tuple, Bits wide at bit Shift of *word
+
+template<typename VT, typename NT, typename Word, std::size_t Shift,
+         std::size_t Bits>
+class bit_ref {
+   public:
+    static constexpr inline const char* get_value_name() { return NT::_name; }
+    using type = VT;
+    using namedtype = typename NT::type;
+    using word_type = std::remove_const_t<Word>;
+    constexpr static inline bool is_a_named_value() { return true; }
+
+    static constexpr std::size_t bits = Bits;
+    static constexpr word_type mask =
+        word_type(Bits >= sizeof(word_type) * CHAR_BIT
+                      ? ~word_type(0)
+                      : word_type((word_type(1) << Bits) - 1));
+
+    explicit constexpr bit_ref(Word* w) noexcept : _w(w) {}
+    constexpr bit_ref(const bit_ref&) noexcept = default;
+
+    constexpr VT get() const noexcept {
+        const word_type raw = word_type(*_w >> Shift) & mask;
+        if constexpr (std::is_same<VT, bool>::value) {
+            return raw != 0;
+        } else if constexpr (std::is_enum<VT>::value) {
+            return VT(extend<std::underlying_type_t<VT>>(raw));
+        } else {
+            return extend<VT>(raw);
+        }
+    }
+    constexpr operator VT() const noexcept { return get(); }
+
+    constexpr const bit_ref& operator=(const VT& value) const noexcept {
+        static_assert(!std::is_const<Word>::value,
+                      "assignment to a field of a read only tuple");
+        const word_type v = word_type(word_type(value) & mask);
+        *_w = word_type((*_w & word_type(~word_type(mask << Shift))) |
+                        word_type(v << Shift));
+        return *this;
+    }
+    constexpr const bit_ref& operator=(const bit_ref& o) const noexcept {
+        return *this = o.get();
+    }
+
+   private:
+    // the integer of the field bits, the top bit sign extended for signed T
+    template<typename T>
+    static constexpr T extend(word_type raw) noexcept {
+        if constexpr (std::is_signed<T>::value) {
+            constexpr unsigned up = 64 - Bits;
+            return T(std::int64_t(std::uint64_t(raw) << up) >> up);
+        } else {
+            return T(raw);
+        }
+    }
+
+    Word* _w;
+};
+
+template<typename... TS>
+class bitpacked_named_tuple {
+    static constexpr std::array<std::size_t, sizeof...(TS)> widths{
+        bits_detail::field_bits<TS>()...};
+
+   public:
+    using type = bitpacked_named_tuple<TS...>;
+    using tuple_type = named_tuple<TS...>;
+
+    static constexpr std::size_t total_bits =
+        (std::size_t(0) + ... + bits_detail::field_bits<TS>());
+    using word_type = bits_detail::word_for_t<total_bits>;
+    static constexpr std::size_t word_bits = sizeof(word_type) * CHAR_BIT;
+
+    static constexpr auto slots =
+        bits_detail::assign_slots<word_bits>(widths);
+
+    static constexpr std::size_t word_count = [] {
+        std::size_t n = 0;
+        for (auto s : slots) n = std::max(n, s.word + 1);
+        return n;
+    }();
+
+    constexpr bitpacked_named_tuple() = default;
+
+    // by name, in any order, like named_tuple(const CT&...)
+    template<typename... CT>
+    constexpr bitpacked_named_tuple(const CT&... nv) {
+        (..., (get<typename CT::namedtype>() = nv.get()));
+    }
+
+    template<typename... CT>
+    constexpr bitpacked_named_tuple(const named_tuple<CT...>& t) {
+        (..., (get<typename CT::namedtype>() =
+                   t[typename CT::namedtype{}].get()));
+    }
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    static constexpr int field_index(std::string_view name) noexcept {
+        return tuple_type::field_index(name);
+    }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            TS::get_value_name()...};
+    }
+
+    template<typename T>
+    constexpr auto get() noexcept {
+        return ref<T, word_type>(_words.data());
+    }
+
+    template<typename T>
+    constexpr auto get() const noexcept {
+        return ref<T, const word_type>(_words.data());
+    }
+
+    template<typename T>
+    constexpr auto operator[](T) noexcept {
+        return get<T>();
+    }
+
+    template<typename T>
+    constexpr auto operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    template<typename F>
+    bitpacked_named_tuple& foreach (F&& f) {
+        (..., f(get<typename TS::namedtype>()));
+        return *this;
+    }
+
+    template<typename F>
+    const bitpacked_named_tuple& foreach (F&& f) const {
+        (..., f(get<typename TS::namedtype>()));
+        return *this;
+    }
+
+    tuple_type to_tuple() const {
+        tuple_type t;
+        (..., (t[typename TS::namedtype{}] =
+                   get<typename TS::namedtype>().get()));
+        return t;
+    }
+
+    const std::array<word_type, word_count>& words() const noexcept {
+        return _words;
+    }
+
+   private:
+    template<typename T, typename Word>
+    static constexpr auto ref(Word* words) noexcept {
+        constexpr auto i = std::size_t(get_index<T>());
+        using NV = std::tuple_element_t<i, std::tuple<TS...>>;
+        return bit_ref<typename NV::type, typename NV::namedtype, Word,
+                       slots[i].shift, widths[i]>{words + slots[i].word};
+    }
+
+    std::array<word_type, word_count> _words{};
+};
+
+// bitpacked_for<named_tuple<TS...>>::type is bitpacked_named_tuple<TS...>
+
+template<typename T>
+struct bitpacked_for;
+
+template<typename... TS>
+struct bitpacked_for<named_tuple<TS...>> {
+    using type = bitpacked_named_tuple<TS...>;
+};
+
+template<typename T>
+using bitpacked_for_t = typename bitpacked_for<T>::type;
+
+}  // namespace nvtuple_ns
+
+template<typename VT, typename NT, typename Word, std::size_t S, std::size_t B>
+inline std::ostream& operator<<(
+    std::ostream& os, const nvtuple_ns::bit_ref<VT, NT, Word, S, B>& r) {
+    os << r.get_value_name() << ": ";
+    // as the named_value of a named_tuple; enums without an operator<<, that
+    // a named_tuple can not print, as their underlying integer
+    if constexpr (requires { os << r.get(); })
+        os << r.get();
+    else
+        os << +std::underlying_type_t<VT>(r.get());
+    return os;
+}
+
+template<typename... TS>
+inline std::ostream& operator<<(
+    std::ostream& os, const nvtuple_ns::bitpacked_named_tuple<TS...>& t) {
+    const char* sep = "";
+    os << "(";
+    t.foreach ([&](const auto& r) {
+        os << sep << r;
+        sep = ", ";
+    });
+    os << ")";
+    return os;
+}
+
+// field F of value type T, stored in B bits of a bitpacked_named_tuple
+#define NVT_FIELD_BITS(F, T, B)                      \
+    NVT_FIELD_TYPE(F, T)                             \
+    namespace nvtuple_ns {                           \
+    template<>                                       \
+    class named_value_bits<decltype(F)> {            \
+       public:                                       \
+        constexpr const static std::size_t value{B}; \
+    };                                               \
+    }
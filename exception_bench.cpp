@@ -0,0 +1,72 @@
+// Benchmark: throw / catch cost of NVT_EXCEPTION compared to
+// std::runtime_error, with and without a call to what() in the handler.
+
+#include <exception_tuple.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+template<typename F>
+double best_ns_per_throw(std::size_t throws, F&& f) {
+    double best = 1e30;
+    for (int rep = 0; rep < 7; ++rep) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < throws; ++i) f(int(i));
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        best = std::min(best, ns / double(throws));
+    }
+    return best;
+}
+
+[[gnu::noinline]] void throw_runtime_error(int code) {
+    throw std::runtime_error("order rejected, code: " + std::to_string(code));
+}
+
+[[gnu::noinline]] void throw_nvt_exception(int code) {
+    throw NVT_EXCEPTION(("error"_, std::string_view("order rejected")),
+                        ("code"_, code));
+}
+
+int main(int argc, char** argv) {
+    const std::size_t throws =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    volatile std::size_t sink = 0;
+
+    double re = best_ns_per_throw(throws, [&](int i) {
+        try {
+            throw_runtime_error(i);
+        } catch (std::exception&) {
+            sink = sink + 1;
+        }
+    });
+    double nvt = best_ns_per_throw(throws, [&](int i) {
+        try {
+            throw_nvt_exception(i);
+        } catch (std::exception&) {
+            sink = sink + 1;
+        }
+    });
+    std::cout << "throw/catch: std::runtime_error " << re
+              << " ns, NVT_EXCEPTION " << nvt << " ns\n";
+
+    re = best_ns_per_throw(throws, [&](int i) {
+        try {
+            throw_runtime_error(i);
+        } catch (std::exception& e) {
+            sink = sink + e.what()[0];
+        }
+    });
+    nvt = best_ns_per_throw(throws, [&](int i) {
+        try {
+            throw_nvt_exception(i);
+        } catch (std::exception& e) {
+            sink = sink + e.what()[0];
+        }
+    });
+    std::cout << "throw/catch + what(): std::runtime_error " << re
+              << " ns, NVT_EXCEPTION " << nvt << " ns\n";
+    return 0;
+}
@@ -3,31 +3,101 @@
 //
 
 #pragma once
+#include <named_format.h>
 #include <named_tuple.h>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
 #include <exception>
-#include <sstream>
+#include <string_view>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 
+// exception_tuple - an exception holding named values. Throwing it costs the
+// construction of the values only: what() formats them lazily, on the first
+// call, into an inline buffer of what_capacity characters (longer text ends
+// with "..."). Concurrent what() calls format once, the other callers wait
+// for the published text.
+
 template<typename... TS>
 class exception_tuple : public std::exception,
                         public nvtuple_ns::named_tuple<TS...> {
    public:
-    std::string mutable _str;
+    static constexpr std::size_t what_capacity = 512;
 
-    exception_tuple<TS...>(const TS&... vs)
+    exception_tuple(const TS&... vs)
         : nvtuple_ns::named_tuple<TS...>(std::forward<const TS>(vs)...) {}
-    exception_tuple<TS...>(TS&&... vs)
+    exception_tuple(TS&&... vs)
         : nvtuple_ns::named_tuple<TS...>(std::forward<TS>(vs)...) {}
 
+    exception_tuple(const exception_tuple& e)
+        : std::exception(e),
+          nvtuple_ns::named_tuple<TS...>(
+              static_cast<const nvtuple_ns::named_tuple<TS...>&>(e)) {
+        if (e._state.load(std::memory_order_acquire) == ready) {
+            std::memcpy(_what, e._what, sizeof(_what));
+            _state.store(ready, std::memory_order_relaxed);
+        }
+    }
+
+    // copies the values, and the text of e if formatted; not concurrent with
+    // what() on this exception
+    exception_tuple& operator=(const exception_tuple& e) {
+        if (this == &e) return *this;
+        std::exception::operator=(e);
+        nvtuple_ns::named_tuple<TS...>::operator=(
+            static_cast<const nvtuple_ns::named_tuple<TS...>&>(e));
+        if (e._state.load(std::memory_order_acquire) == ready) {
+            std::memcpy(_what, e._what, sizeof(_what));
+            _state.store(ready, std::memory_order_relaxed);
+        } else {
+            _state.store(empty, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
     virtual const char* what() const noexcept {
-        std::stringstream buff{};
-        buff << *static_cast<const nvtuple_ns::named_tuple<TS...>*>(this);
-        _str = buff.str();
-        return _str.c_str();
+        int state = _state.load(std::memory_order_acquire);
+        if (state == ready) return _what;
+        if (state == empty &&
+            _state.compare_exchange_strong(state, busy,
+                                           std::memory_order_acquire)) {
+            format_what();
+            _state.store(ready, std::memory_order_release);
+            return _what;
+        }
+        while (_state.load(std::memory_order_acquire) != ready)
+            std::this_thread::yield();
+        return _what;
     }
+
+   private:
+    enum : int { empty, busy, ready };
+
+    void format_what() const noexcept {
+        static constexpr std::string_view more{"..."};
+        const auto& t = static_cast<const std::tuple<TS...>&>(*this);
+        nvtuple_ns::format_detail::writer w{_what,
+                                            _what + sizeof(_what) - 1 -
+                                                more.size()};
+        nvtuple_ns::format_detail::format_tuple(w, t);
+        if (!w.ok) {
+            std::memcpy(w.p, more.data(), more.size());
+            w.p += more.size();
+        }
+        *w.p = '\0';
+    }
+
+    mutable std::atomic<int> _state{empty};
+    mutable char _what[what_capacity + 1];
 };
 
-#define NVT_EXCEPTION(...)                                    \
-    exception_tuple(("file"_, __FILE__), ("line"_, __LINE__), \
-                    ("func"_, __PRETTY_FUNCTION__)__VA_OPT__(, ) __VA_ARGS__)
+// the source location fields are views of the static __FILE__ and
+// __PRETTY_FUNCTION__ strings, no allocation on the throw path
+
+#define NVT_EXCEPTION(...)                                             \
+    exception_tuple(("file"_, std::string_view(__FILE__)),            \
+                    ("line"_, __LINE__),                               \
+                    ("func"_, std::string_view(__PRETTY_FUNCTION__))   \
+                        __VA_OPT__(, ) __VA_ARGS__)
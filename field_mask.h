@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// field_mask - fixed size bit set over the fields of a named tuple, bit i
+// for the field of index i. Used for the changed fields of a named_patch
+// and the present fields of a sparse_named_tuple.
+
+namespace nvtuple_ns {
+
+template<std::size_t N>
+class field_mask {
+   public:
+    static constexpr std::size_t word_count = (N + 63) / 64;
+    static constexpr std::size_t byte_size = (N + 7) / 8;
+
+    static constexpr std::size_t size() noexcept { return N; }
+
+    constexpr bool test(std::size_t i) const noexcept {
+        return (_words[i / 64] >> (i % 64)) & 1;
+    }
+    constexpr field_mask& set(std::size_t i, bool v = true) noexcept {
+        const std::uint64_t bit = std::uint64_t(1) << (i % 64);
+        _words[i / 64] = v ? (_words[i / 64] | bit) : (_words[i / 64] & ~bit);
+        return *this;
+    }
+    constexpr field_mask& reset() noexcept {
+        _words = {};
+        return *this;
+    }
+    constexpr std::size_t count() const noexcept {
+        std::size_t n = 0;
+        for (auto w : _words) n += std::size_t(std::popcount(w));
+        return n;
+    }
+    constexpr bool any() const noexcept {
+        for (auto w : _words)
+            if (w) return true;
+        return false;
+    }
+    constexpr bool none() const noexcept { return !any(); }
+
+    // f(i) for every set bit, in increasing order
+    template<typename F>
+    constexpr void for_each_set(F&& f) const {
+        for (std::size_t w = 0; w < word_count; ++w)
+            for (std::uint64_t bits = _words[w]; bits; bits &= bits - 1)
+                f(w * 64 + std::size_t(std::countr_zero(bits)));
+    }
+
+    // byte b of the wire encoding
+    constexpr std::uint8_t byte(std::size_t b) const noexcept {
+        return std::uint8_t(_words[b / 8] >> (8 * (b % 8)));
+    }
+    constexpr void set_byte(std::size_t b, std::uint8_t v) noexcept {
+        const unsigned shift = 8 * (b % 8);
+        _words[b / 8] = (_words[b / 8] & ~(std::uint64_t(0xff) << shift)) |
+                        (std::uint64_t(v) << shift);
+    }
+
+    constexpr field_mask& operator|=(const field_mask& o) noexcept {
+        for (std::size_t w = 0; w < word_count; ++w) _words[w] |= o._words[w];
+        return *this;
+    }
+
+    friend constexpr bool operator==(const field_mask&,
+                                     const field_mask&) = default;
+
+   private:
+    std::array<std::uint64_t, word_count ? word_count : 1> _words{};
+};
+
+namespace mask_detail {
+
+// f(std::integral_constant<std::size_t, I>) for every field I set in the
+// mask, through a table of one function per field index
+template<typename F, std::size_t... I>
+void masked_dispatch(const field_mask<sizeof...(I)>& mask, F& f,
+                     std::index_sequence<I...>) {
+    using fn = void (*)(F&);
+    static constexpr fn table[] = {
+        +[](F& g) { g(std::integral_constant<std::size_t, I>{}); }...};
+    mask.for_each_set([&f](std::size_t i) { table[i](f); });
+}
+
+}  // namespace mask_detail
+
+// for_each_masked(mask, f) - f(std::integral_constant<std::size_t, I>) for
+// every set bit I, so f can use I as a compile time field index
+template<std::size_t N, typename F>
+void for_each_masked(const field_mask<N>& mask, F&& f) {
+    if constexpr (N > 0)
+        mask_detail::masked_dispatch(mask, f, std::make_index_sequence<N>{});
+}
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+
+// fixed_string<N> - string value of up to N characters stored inline, no heap
+// allocation, trivially copyable, so a named_tuple of fixed capacity fields
+// stays trivially copyable (and trivially serializable).
+// Text longer than N is truncated, assign() reports it.
+
+namespace nvtuple_ns {
+
+template<std::size_t N>
+class fixed_string {
+   public:
+    using size_type =
+        std::conditional_t<(N < 256), std::uint8_t, std::uint32_t>;
+
+    static constexpr std::size_t capacity() noexcept { return N; }
+
+    constexpr fixed_string() noexcept = default;
+    constexpr fixed_string(const char* s) noexcept { assign(s); }
+    constexpr fixed_string(std::string_view s) noexcept { assign(s); }
+
+    template<std::size_t M>
+    constexpr fixed_string(const fixed_string<M>& s) noexcept {
+        assign(s.view());
+    }
+
+    constexpr fixed_string& operator=(const char* s) noexcept {
+        assign(s);
+        return *this;
+    }
+    constexpr fixed_string& operator=(std::string_view s) noexcept {
+        assign(s);
+        return *this;
+    }
+
+    // copy up to N characters of s, false if s was truncated
+    constexpr bool assign(std::string_view s) noexcept {
+        const std::size_t n = std::min(s.size(), N);
+        std::copy_n(s.data(), n, _data);
+        std::fill(_data + n, _data + N + 1, '\0');
+        _size = size_type(n);
+        return n == s.size();
+    }
+
+    constexpr std::size_t size() const noexcept { return _size; }
+    constexpr std::size_t length() const noexcept { return _size; }
+    constexpr bool empty() const noexcept { return _size == 0; }
+
+    constexpr const char* data() const noexcept { return _data; }
+    constexpr const char* c_str() const noexcept { return _data; }
+    constexpr const char* begin() const noexcept { return _data; }
+    constexpr const char* end() const noexcept { return _data + _size; }
+
+    constexpr std::string_view view() const noexcept { return {_data, _size}; }
+    constexpr operator std::string_view() const noexcept { return view(); }
+
+    friend constexpr bool operator==(const fixed_string& a,
+                                     std::string_view b) noexcept {
+        return a.view() == b;
+    }
+    friend constexpr auto operator<=>(const fixed_string& a,
+                                      std::string_view b) noexcept {
+        return a.view() <=> b;
+    }
+    template<std::size_t M>
+    friend constexpr bool operator==(const fixed_string& a,
+                                     const fixed_string<M>& b) noexcept {
+        return a.view() == b.view();
+    }
+    template<std::size_t M>
+    friend constexpr auto operator<=>(const fixed_string& a,
+                                      const fixed_string<M>& b) noexcept {
+        return a.view() <=> b.view();
+    }
+
+   private:
+    char _data[N + 1]{};  // zero filled past the text, always terminated
+    size_type _size{0};
+};
+
+template<std::size_t M>
+fixed_string(const char (&)[M]) -> fixed_string<M - 1>;
+
+template<typename T>
+struct is_fixed_string : std::false_type {};
+
+template<std::size_t N>
+struct is_fixed_string<fixed_string<N>> : std::true_type {};
+
+}  // namespace nvtuple_ns
+
+template<std::size_t N>
+inline std::ostream& operator<<(std::ostream& os,
+                                const nvtuple_ns::fixed_string<N>& s) {
+    return os << s.view();
+}
@@ -0,0 +1,54 @@
+
+#include <atomic_named_tuple.h>
+#include <named_tuple.h>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using stats_t =
+    nvt::named_tuple<nvt::named_value<std::uint64_t, decltype("hits"_)>,
+                     nvt::named_value<bool, decltype("live"_)>,
+                     nvt::named_value<double, decltype("last_px"_)>>;
+
+TEST(AtomicNamedTuple, ByName) {
+    static_assert(nvt::is_atomic_field_v<std::uint64_t>);
+    static_assert(!nvt::is_atomic_field_v<std::string>);
+    static_assert(!nvt::is_atomic_field_v<nvt::fixed_string<32>>);
+
+    nvt::atomic_for_t<stats_t> st{stats_t{("hits"_, std::uint64_t(3)),
+                                          ("live"_, true), ("last_px"_, 1.5)}};
+    EXPECT_EQ(st.load<"hits"_>(), 3U);
+    EXPECT_EQ(st.fetch_add<"hits"_>(2, std::memory_order_relaxed), 3U);
+    st.store<"live"_>(false);
+    EXPECT_FALSE(st["live"_].load());
+    EXPECT_EQ(st.exchange<"last_px"_>(2.5), 1.5);
+    EXPECT_EQ(st.fetch_add<"last_px"_>(0.5), 2.5);
+
+    std::uint64_t expected = 4;
+    EXPECT_FALSE(st.compare_exchange<"hits"_>(expected, 10));
+    EXPECT_EQ(expected, 5U);
+    EXPECT_TRUE(st.compare_exchange<"hits"_>(expected, 10));
+
+    std::stringstream strm;
+    strm << st;
+    EXPECT_EQ(strm.str(), "(hits: 10, live: 0, last_px: 3)");
+    stats_t snap = st.snapshot();
+    EXPECT_EQ(snap["hits"_].get(), 10U);
+}
+
+TEST(AtomicNamedTuple, Threads) {
+    nvt::atomic_for_t<stats_t> st;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&st] {
+            for (int i = 0; i < 100000; ++i)
+                st.fetch_add<"hits"_>(1, std::memory_order_relaxed);
+        });
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(st.load<"hits"_>(), 400000U);
+}
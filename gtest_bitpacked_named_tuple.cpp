@@ -0,0 +1,99 @@
+
+#include <bitpacked_named_tuple.h>
+#include <named_tuple.h>
+#include <iostream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+enum class side : std::uint8_t { buy = 1, sell = 2 };
+enum class tick : std::int8_t { down = -1, flat = 0, up = 1 };
+
+static std::ostream& operator<<(std::ostream& os, side s) {
+    return os << (s == side::buy ? "buy" : "sell");
+}
+
+NVT_FIELD_BITS("side"_, side, 2)
+NVT_FIELD_BITS("qty"_, std::uint32_t, 20)
+NVT_FIELD_BITS("venue"_, std::uint8_t, 5)
+NVT_FIELD_BITS("delta"_, std::int16_t, 12)
+NVT_FIELD_BITS("px"_, std::uint64_t, 40)
+NVT_FIELD_BITS("tick"_, tick, 2)
+
+using level_t = nvt::named_tuple<decltype(~"side"_), decltype(~"qty"_),
+                                 decltype(~"venue"_),
+                                 nvt::named_value<bool, decltype("live"_)>>;
+using packed_level_t = nvt::bitpacked_for_t<level_t>;
+
+// 2 + 20 + 5 + 1 bits in one 32 bit word
+static_assert(packed_level_t::total_bits == 28);
+static_assert(sizeof(packed_level_t) == 4);
+static_assert(sizeof(level_t) >= 3 * sizeof(packed_level_t));
+
+using quote_t =
+    nvt::bitpacked_named_tuple<decltype(~"px"_), decltype(~"qty"_),
+                               decltype(~"delta"_), decltype(~"side"_)>;
+static_assert(quote_t::word_count == 2);
+static_assert(sizeof(quote_t) == 16);
+
+TEST(BitpackedNamedTuple, ShiftMaskAccess) {
+    packed_level_t l{("qty"_, std::uint32_t(1000)), ("side"_, side::sell)};
+    l["venue"_] = std::uint8_t(31);
+    l["live"_] = true;
+    EXPECT_EQ(l["qty"_].get(), 1000U);
+    EXPECT_EQ(l["side"_].get(), side::sell);
+    EXPECT_EQ(l["venue"_].get(), 31);
+    EXPECT_TRUE(l["live"_].get());
+
+    // neighbours are not touched, values are truncated to the width
+    l["qty"_] = std::uint32_t((1 << 20) + 7);
+    EXPECT_EQ(l["qty"_].get(), 7U);
+    EXPECT_EQ(l["venue"_].get(), 31);
+    EXPECT_EQ(l["side"_].get(), side::sell);
+
+    std::uint32_t q = l["qty"_];
+    EXPECT_EQ(q, 7U);
+
+    // printed as the named_tuple prints, std::uint8_t as a character
+    l["venue"_] = std::uint8_t('\n');
+    std::stringstream strm;
+    strm << l;
+    EXPECT_EQ(strm.str(), "(side: sell, qty: 7, venue: \n, live: 1)");
+    std::stringstream tstrm;
+    tstrm << l.to_tuple();
+    EXPECT_EQ(tstrm.str(), strm.str());
+}
+
+TEST(BitpackedNamedTuple, SignedAndWideFields) {
+    quote_t q;
+    q["delta"_] = std::int16_t(-5);
+    q["px"_] = (std::uint64_t(1) << 40) - 1;
+    q["qty"_] = std::uint32_t(12345);
+    EXPECT_EQ(q["delta"_].get(), -5);
+    EXPECT_EQ(q["px"_].get(), (std::uint64_t(1) << 40) - 1);
+    EXPECT_EQ(q["qty"_].get(), 12345U);
+    q["delta"_] = std::int16_t(2047);
+    EXPECT_EQ(q["delta"_].get(), 2047);
+
+    // enums with a signed underlying type are sign extended
+    nvt::bitpacked_named_tuple<decltype(~"tick"_), decltype(~"venue"_)> m;
+    m["tick"_] = tick::down;
+    EXPECT_EQ(m["tick"_].get(), tick::down);
+    m["venue"_] = std::uint8_t('\t');
+    std::stringstream strm;
+    strm << m;  // no operator<< for tick, printed as its integer
+    EXPECT_EQ(strm.str(), "(tick: -1, venue: \t)");
+
+    level_t t{("side"_, side::buy), ("qty"_, std::uint32_t(9)),
+              ("venue"_, std::uint8_t(3)), ("live"_, false)};
+    packed_level_t p{t};
+    const auto back = p.to_tuple();
+    EXPECT_EQ(back["qty"_].get(), 9U);
+    EXPECT_EQ(back["venue"_].get(), 3);
+    EXPECT_EQ(back["side"_].get(), side::buy);
+
+    const packed_level_t& cp = p;
+    EXPECT_EQ(cp["qty"_].get(), 9U);
+}
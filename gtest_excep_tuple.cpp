@@ -7,12 +7,30 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <iterator>
+#include <new>
 #include <regex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace nvt = nvtuple_ns;
 
+// allocations made by the current thread
+static thread_local std::size_t allocations = 0;
+
+void* operator new(std::size_t n) {
+    ++allocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
 TEST(ExceptionTuples, BasicException) {
     std::stringstream ostr;
     std::regex pathex("/.*/");
@@ -26,7 +44,7 @@ TEST(ExceptionTuples, BasicException) {
     auto res = std::regex_replace(ostr.str(), pathex, "");
     EXPECT_EQ(
         res,
-        "got exception: (file: \"gtest_excep_tuple.cpp\", line: 21, func: "
+        "got exception: (file: \"gtest_excep_tuple.cpp\", line: 39, func: "
         "\"virtual void ExceptionTuples_BasicException_Test::TestBody()\")");
 }
 
@@ -35,15 +53,70 @@ TEST(ExceptionTuples, ExceptionArgs) {
     std::regex pathex("/.*/");
 
     try {
-        throw NVT_EXCEPTION(("iarg"_, 123), ("darg"_, 3.25),
-                            ("sarg"_, "this is an example"));
+        auto sarg = ("sarg"_, "this is an example");
+        throw NVT_EXCEPTION(("iarg"_, 123), ("darg"_, 3.25), sarg);
     } catch (std::exception& e) {
         ostr << "got exception: " << e.what();
     }
     auto res = std::regex_replace(ostr.str(), pathex, "");
     EXPECT_EQ(
         res,
-        "got exception: (file: \"gtest_excep_tuple.cpp\", line: 39, func: "
+        "got exception: (file: \"gtest_excep_tuple.cpp\", line: 57, func: "
         "\"virtual void ExceptionTuples_ExceptionArgs_Test::TestBody()\", "
         "iarg: 123, darg: 3.25, sarg: \"this is an example\")");
 }
+
+TEST(ExceptionTuples, NoAllocation) {
+    const std::size_t before = allocations;
+    std::size_t after = 0;
+    try {
+        throw NVT_EXCEPTION(("code"_, 42), ("px"_, 1.5));
+    } catch (std::exception& e) {
+        std::string_view text = e.what();
+        EXPECT_EQ(text.substr(text.size() - 18), "code: 42, px: 1.5)");
+        EXPECT_EQ(e.what(), text.data());  // formatted once
+        after = allocations;
+    }
+    // the exception object itself comes from __cxa_allocate_exception
+    EXPECT_EQ(after, before);
+}
+
+TEST(ExceptionTuples, ConcurrentWhatAndCopy) {
+    auto e = NVT_EXCEPTION(("code"_, 7));
+    std::vector<std::thread> threads;
+    std::vector<std::string> texts(4);
+    for (std::size_t i = 0; i < texts.size(); ++i)
+        threads.emplace_back([&, i] { texts[i] = e.what(); });
+    for (auto& t : threads) t.join();
+    for (auto& t : texts) EXPECT_EQ(t, e.what());
+
+    auto c = e;
+    EXPECT_STREQ(c.what(), e.what());
+    EXPECT_NE(c.what(), e.what());
+}
+
+TEST(ExceptionTuples, CopyAssignment) {
+    const auto make = [](int code) { return NVT_EXCEPTION(("code"_, code)); };
+    static_assert(std::is_copy_assignable_v<decltype(make(0))>);
+    auto a = make(1);
+    auto b = make(2);
+    const std::string text = b.what();
+    EXPECT_NE(std::string(a.what()), text);
+
+    a = b;  // formatted text copied
+    EXPECT_EQ(a["code"_].get(), 2);
+    EXPECT_EQ(a.what(), text);
+
+    auto c = make(3);
+    a = c;  // not formatted yet, a formats again
+    EXPECT_EQ(a["code"_].get(), 3);
+    EXPECT_EQ(std::string(a.what()), c.what());
+}
+
+TEST(ExceptionTuples, LongWhatIsTruncated) {
+    const std::string big(2000, 'x');
+    auto e = NVT_EXCEPTION(("big"_, big));
+    std::string_view text = e.what();
+    EXPECT_LE(text.size(), e.what_capacity);
+    EXPECT_EQ(text.substr(text.size() - 9), "big: \"...");
+}
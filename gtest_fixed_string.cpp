@@ -0,0 +1,109 @@
+
+#include <fixed_string.h>
+#include <named_format.h>
+#include <named_json.h>
+#include <named_serialize.h>
+#include <named_tuple.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+NVT_FIELD_TYPE("sym"_, nvt::fixed_string<8>)
+NVT_FIELD_TYPE("venue"_, std::string_view)
+NVT_FIELD_TYPE("src"_, const char*)
+
+TEST(FixedString, Basics) {
+    constexpr nvt::fixed_string<8> s{"AAPL"};
+    static_assert(s.size() == 4 && s.capacity() == 8);
+    static_assert(s == "AAPL" && s != "AAP" && s < "MSFT");
+    static_assert(std::is_trivially_copyable_v<nvt::fixed_string<8>>);
+    static_assert(sizeof(nvt::fixed_string<7>) == 9);
+
+    nvt::fixed_string f{"IBM"};
+    static_assert(std::is_same_v<decltype(f), nvt::fixed_string<3>>);
+    EXPECT_TRUE(f == nvt::fixed_string<16>("IBM"));
+    EXPECT_EQ(std::string(f.c_str()), "IBM");
+
+    nvt::fixed_string<4> t;
+    EXPECT_TRUE(t.empty());
+    EXPECT_FALSE(t.assign("toolong"));
+    EXPECT_EQ(t.view(), "tool");
+    t = std::string("ab");
+    EXPECT_EQ(t, "ab");
+    std::stringstream strm;
+    strm << t;
+    EXPECT_EQ(strm.str(), "ab");
+}
+
+TEST(FixedString, FieldTypes) {
+    auto t = nvt::named_tuple{("sym"_, "AAPL"), ("venue"_, "XNAS"),
+                              ("src"_, "feed"), ("qty"_, 10)};
+    static_assert(std::is_same_v<decltype(t["sym"_].get()),
+                                 nvt::fixed_string<8>&>);
+    static_assert(std::is_same_v<decltype(t["venue"_].get()),
+                                 std::string_view&>);
+    static_assert(std::is_same_v<decltype(t["src"_].get()), const char*&>);
+    EXPECT_TRUE(t["sym"_].get() == "AAPL");
+
+    std::stringstream strm;
+    strm << t;
+    EXPECT_EQ(strm.str(),
+              "(sym: \"AAPL\", venue: \"XNAS\", src: \"feed\", qty: 10)");
+    EXPECT_EQ(nvt::format(t), strm.str());
+    EXPECT_EQ(nvt::to_json(t),
+              "{\"sym\":\"AAPL\",\"venue\":\"XNAS\",\"src\":\"feed\","
+              "\"qty\":10}");
+
+    t << ("sym"_, "MSFT") << nvt::named_tuple{("venue"_, "ARCA")};
+    EXPECT_EQ(t["sym"_].get(), "MSFT");
+    EXPECT_EQ(t["venue"_].get(), "ARCA");
+}
+
+TEST(FixedString, TriviallyCopyableRecord) {
+    using rec_t = nvt::named_tuple<
+        nvt::named_value<nvt::fixed_string<8>, decltype("sym"_)>,
+        nvt::named_value<double, decltype("px"_)>>;
+    // std::tuple assignment is never trivial, copy and destruction are
+    static_assert(std::is_trivially_copy_constructible_v<rec_t>);
+    static_assert(std::is_trivially_destructible_v<rec_t>);
+    static_assert(nvt::is_trivially_serializable_v<rec_t>);
+
+    rec_t r{("sym"_, "GOOG"), ("px"_, 2.5)};
+    std::vector<std::byte> buf;
+    EXPECT_TRUE(nvt::serialize(r, nvt::vector_sink{buf}));
+    EXPECT_EQ(buf.size(), nvt::serialized_size_v<rec_t>);
+    auto r2 = nvt::deserialize<rec_t>(nvt::buffer_source{buf});
+    ASSERT_TRUE(r2);
+    EXPECT_EQ((*r2)["sym"_].get(), "GOOG");
+
+    auto r3 = nvt::from_json<rec_t>("{\"sym\":\"IBM\",\"px\":1}");
+    EXPECT_EQ(r3["sym"_].get(), "IBM");
+    EXPECT_THROW(nvt::from_json<rec_t>("{\"sym\":\"123456789\"}"),
+                 std::exception);
+}
+
+TEST(FixedString, StringViewSerialization) {
+    using rec_t = nvt::named_tuple<
+        nvt::named_value<std::string_view, decltype("venue"_)>,
+        nvt::named_value<int, decltype("qty"_)>>;
+    static_assert(!nvt::is_trivially_serializable_v<rec_t>);
+    rec_t r{("venue"_, "BATS"), ("qty"_, 3)};
+    std::vector<std::byte> buf;
+    EXPECT_TRUE(nvt::serialize(r, nvt::vector_sink{buf}));
+    EXPECT_EQ(buf.size(), 4 + 4 + sizeof(int));
+    auto r2 = nvt::deserialize<rec_t>(nvt::buffer_source{buf});
+    ASSERT_TRUE(r2);
+    EXPECT_EQ((*r2)["venue"_].get(), "BATS");
+    EXPECT_EQ((*r2)["venue"_].get().data(),
+              reinterpret_cast<const char*>(buf.data() + 4));
+
+    std::string text = "{\"venue\":\"EDGX\",\"qty\":4}";
+    auto r3 = nvt::from_json<rec_t>(text);
+    EXPECT_EQ(r3["venue"_].get(), "EDGX");
+    EXPECT_THROW(nvt::from_json<rec_t>("{\"venue\":\"a\\nb\"}"),
+                 std::exception);
+}
@@ -0,0 +1,123 @@
+#include <hash_index.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <named_view.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using quote_t =
+    nvt::named_tuple<nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<nvt::fixed_string<4>, decltype("venue"_)>,
+                     nvt::named_value<int, decltype("level"_)>,
+                     nvt::named_value<double, decltype("px"_)>>;
+using quote_table_t = nvt::table_for_t<quote_t>;
+using index_t = nvt::hash_index<quote_table_t, "sym"_, "venue"_>;
+
+// the index keeps a pointer to its table, temporaries are rejected
+static_assert(std::is_constructible<index_t, const quote_table_t&>::value);
+static_assert(!std::is_constructible<index_t, quote_table_t>::value);
+static_assert(!std::is_constructible<index_t, const quote_table_t>::value);
+
+static const char* const venues[]{"XNYS", "XNAS", "BATS", "ARCA"};
+
+static void add_quote(quote_table_t& table, const std::string& sym,
+                      const char* venue, int level) {
+    quote_t q{("sym"_, sym), ("level"_, level), ("px"_, level * 0.5)};
+    q["venue"_].get() = venue;
+    table.push_back(q);
+}
+
+TEST(HashIndex, CompositeKeyLookup) {
+    quote_table_t table;
+    for (int i = 0; i < 5000; ++i) {
+        std::string sym{"S"};
+        add_quote(table, sym += std::to_string(i / 4), venues[i % 4], i);
+    }
+    index_t idx{table};
+    EXPECT_EQ(idx.size(), 5000u);
+    EXPECT_GE(idx.capacity() * 3, idx.size() * 4);
+
+    static_assert(std::is_same<index_t::key_type,
+                               nvt::named_tuple<
+                                   nvt::named_value<std::string,
+                                                    decltype("sym"_)>,
+                                   nvt::named_value<nvt::fixed_string<4>,
+                                                    decltype("venue"_)>>>::
+                                  value);
+
+    // a narrow key of other string types, in another field order
+    using probe_t = nvt::named_tuple<
+        nvt::named_value<std::string_view, decltype("venue"_)>,
+        nvt::named_value<std::string_view, decltype("sym"_)>>;
+    EXPECT_EQ(idx.find(probe_t{("venue"_, std::string_view("BATS")),
+                               ("sym"_, std::string_view("S17"))}),
+              17u * 4 + 2);
+    EXPECT_EQ(idx.find(nvt::named_tuple{("sym"_, std::string("S0")),
+                                        ("venue"_, std::string("XNYS"))}),
+              0u);
+    EXPECT_EQ(idx.find(probe_t{("venue"_, std::string_view("XLON")),
+                               ("sym"_, std::string_view("S17"))}),
+              index_t::npos);
+    EXPECT_FALSE(idx.contains(probe_t{("venue"_, std::string_view("XNYS")),
+                                      ("sym"_, std::string_view("S1250"))}));
+
+    // a full row is a key too
+    EXPECT_EQ(idx.find(table.to_tuple(4321)), 4321u);
+    EXPECT_EQ(idx.hash(table.to_tuple(9)),
+              idx.hash(nvt::project<"sym"_, "venue"_>(table.row(9))));
+}
+
+TEST(HashIndex, DuplicatesAndUpdate) {
+    quote_table_t table;
+    add_quote(table, "IBM", "XNYS", 1);
+    add_quote(table, "IBM", "XNAS", 2);
+    add_quote(table, "IBM", "XNYS", 3);
+    index_t idx{table};
+
+    const auto key =
+        nvt::named_tuple{("sym"_, std::string("IBM")),
+                         ("venue"_, std::string("XNYS"))};
+    EXPECT_EQ(idx.find(key), 0u);
+    std::vector<std::size_t> rows;
+    EXPECT_EQ(idx.for_each(key, [&](std::size_t r) { rows.push_back(r); }),
+              2u);
+    EXPECT_EQ(rows, (std::vector<std::size_t>{0, 2}));
+
+    // rows appended after the index was built, across several rehashes
+    for (int i = 0; i < 1000; ++i) add_quote(table, "MSFT", venues[i % 4], i);
+    EXPECT_FALSE(idx.contains(table.to_tuple(500)));
+    idx.update();
+    EXPECT_EQ(idx.size(), table.size());
+    EXPECT_EQ(idx.find(table.to_tuple(500)), 4u);
+    EXPECT_EQ(idx.for_each(table.to_tuple(500), [](std::size_t) {}), 250u);
+    EXPECT_EQ(idx.find(key), 0u);
+
+    // integer and floating point key fields
+    nvt::hash_index<quote_table_t, "level"_, "px"_> by_level{table};
+    EXPECT_EQ(by_level.find(nvt::named_tuple{("level"_, 999), ("px"_, 499.5)}),
+              table.size() - 1);
+    EXPECT_EQ(by_level.find(nvt::named_tuple{("level"_, 999), ("px"_, 1.0)}),
+              by_level.npos);
+
+    // a table that shrank is indexed again
+    table.resize(2);
+    idx.update();
+    EXPECT_EQ(idx.size(), 2u);
+    EXPECT_EQ(idx.for_each(key, [](std::size_t) {}), 1u);
+    table.clear();
+    idx.update();
+    EXPECT_TRUE(idx.empty());
+    EXPECT_EQ(idx.find(key), index_t::npos);
+    add_quote(table, "IBM", "XNAS", 4);
+    idx.update();
+    EXPECT_EQ(idx.find(key), index_t::npos);
+    EXPECT_EQ(idx.find(nvt::named_tuple{("sym"_, std::string("IBM")),
+                                        ("venue"_, std::string("XNAS"))}),
+              0u);
+}
@@ -0,0 +1,29 @@
+
+// string literals as inline fixed_string<N> values, for the whole program
+#define NVT_STRING_LITERAL_POLICY nvtuple_ns::literal_as_fixed_string
+
+#include <named_tuple.h>
+#include <iostream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+NVT_FIELD_TYPE("name"_, std::string)
+
+TEST(LiteralPolicy, FixedString) {
+    auto t = nvt::named_tuple{("sym"_, "AAPL"), ("px"_, 1.5),
+                              ("name"_, "Apple Inc")};
+    static_assert(std::is_same_v<decltype(t["sym"_].get()),
+                                 nvt::fixed_string<4>&>);
+    static_assert(std::is_same_v<decltype(t["name"_].get()), std::string&>);
+
+    std::stringstream strm;
+    strm << t;
+    EXPECT_EQ(strm.str(), "(sym: \"AAPL\", px: 1.5, name: \"Apple Inc\")");
+
+    auto r = nvt::named_tuple{("sym"_, "IBM"), ("px"_, 2.0)};
+    static_assert(std::is_trivially_copy_constructible_v<decltype(r)>);
+    static_assert(std::is_trivially_destructible_v<decltype(r)>);
+}
@@ -0,0 +1,184 @@
+#include <exception_tuple.h>
+#include <mapped_table.h>
+#include <named_tuple.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<nvt::fixed_string<8>, decltype("sym"_)>,
+                     nvt::named_value<std::string, decltype("note"_)>,
+                     nvt::named_value<bool, decltype("buy"_)>>;
+
+using table_t = nvt::mapped_table_for_t<order_t>;
+using writer_t = nvt::mapped_table_for<order_t>::writer_type;
+
+static std::string temp_path(const char* name) {
+    return testing::TempDir() + name;
+}
+
+static void write_orders(const std::string& path, int rows) {
+    writer_t w{path};
+    for (int i = 0; i < rows; ++i) {
+        order_t o{("id"_, i), ("px"_, i * 0.5), ("buy"_, i % 2 == 0)};
+        const char sym[]{'S', char('0' + i % 10), '\0'};
+        o["sym"_].get() = sym;
+        o["note"_] = std::string(std::size_t(i % 7), 'n');
+        w.push_back(o);
+    }
+    EXPECT_EQ(w.size(), std::size_t(rows));
+    w.close();
+}
+
+TEST(MappedTable, RoundTrip) {
+    const std::string path = temp_path("nvt_mapped_round_trip.nvt");
+    write_orders(path, 1000);
+
+    auto t = table_t::open(path);
+    ASSERT_EQ(t.size(), 1000u);
+    EXPECT_EQ(std::string(t.names()[3]), "note");
+
+    std::span<const double> px = t["px"_];
+    ASSERT_EQ(px.size(), 1000u);
+    EXPECT_EQ(px[10], 5.0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(px.data()) % 4096, 0u);
+    t.prefetch<decltype("id"_)>();
+    long sum = 0;
+    for (int id : t.column<decltype("id"_)>()) sum += id;
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    EXPECT_EQ(t["sym"_][13], "S3");
+    EXPECT_EQ(t["note"_][13], "nnnnnn");
+    EXPECT_EQ(t["note"_][14], "");
+    EXPECT_FALSE(t["buy"_][13]);
+
+    const order_t o = t.to_tuple(999);
+    EXPECT_EQ(o["id"_].get(), 999);
+    EXPECT_EQ(o["note"_].get(), "nnnnn");
+    EXPECT_EQ(o["sym"_].get(), "S9");
+
+    auto moved = std::move(t);
+    EXPECT_EQ(moved["id"_][500], 500);
+    std::remove(path.c_str());
+}
+
+TEST(MappedTable, EmptyTable) {
+    const std::string path = temp_path("nvt_mapped_empty.nvt");
+    write_orders(path, 0);
+    auto t = table_t::open(path);
+    EXPECT_TRUE(t.empty());
+    EXPECT_EQ(t["note"_].size(), 0u);
+    std::remove(path.c_str());
+}
+
+TEST(MappedTable, SchemaCheck) {
+    const std::string path = temp_path("nvt_mapped_schema.nvt");
+    write_orders(path, 10);
+
+    using renamed_t = nvt::mapped_table<
+        nvt::named_value<int, decltype("id"_)>,
+        nvt::named_value<double, decltype("price"_)>,
+        nvt::named_value<nvt::fixed_string<8>, decltype("sym"_)>,
+        nvt::named_value<std::string, decltype("note"_)>,
+        nvt::named_value<bool, decltype("buy"_)>>;
+    using retyped_t = nvt::mapped_table<
+        nvt::named_value<long, decltype("id"_)>,
+        nvt::named_value<double, decltype("px"_)>,
+        nvt::named_value<nvt::fixed_string<8>, decltype("sym"_)>,
+        nvt::named_value<std::string, decltype("note"_)>,
+        nvt::named_value<bool, decltype("buy"_)>>;
+    using shorter_t =
+        nvt::mapped_table<nvt::named_value<int, decltype("id"_)>>;
+
+    EXPECT_THROW(renamed_t::open(path), std::exception);
+    EXPECT_THROW(retyped_t::open(path), std::exception);
+    EXPECT_THROW(shorter_t::open(path), std::exception);
+    EXPECT_THROW(table_t::open(temp_path("nvt_mapped_missing.nvt")),
+                 std::exception);
+
+    {
+        std::fstream f{path, std::ios::in | std::ios::out | std::ios::binary};
+        f.seekp(0);
+        f.write("BADMAGIC", 8);
+    }
+    try {
+        table_t::open(path);
+        FAIL() << "expected an exception";
+    } catch (const std::exception& e) {
+        EXPECT_NE(std::string(e.what()).find("not a mapped_table file"),
+                  std::string::npos);
+    }
+    std::remove(path.c_str());
+}
+
+// overwrite the 8 bytes at pos of the file
+static void patch_u64(const std::string& path, std::streamoff pos,
+                      std::uint64_t v) {
+    std::fstream f{path, std::ios::in | std::ios::out | std::ios::binary};
+    f.seekp(pos);
+    f.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static std::uint64_t read_u64(const std::string& path, std::streamoff pos) {
+    std::ifstream f{path, std::ios::binary};
+    f.seekg(pos);
+    std::uint64_t v = 0;
+    f.read(reinterpret_cast<char*>(&v), sizeof(v));
+    return v;
+}
+
+static void expect_open_error(const std::string& path, const char* error) {
+    try {
+        table_t::open(path);
+        FAIL() << "expected an exception";
+    } catch (const std::exception& e) {
+        EXPECT_NE(std::string(e.what()).find(error), std::string::npos)
+            << e.what();
+    }
+}
+
+TEST(MappedTable, CorruptFile) {
+    const std::string path = temp_path("nvt_mapped_corrupt.nvt");
+    // the file header is 32 bytes, then 64 bytes per column header, with
+    // the column offset at byte 48; the row count is at byte 16, the byte
+    // order mark at byte 24
+    const std::streamoff note_offset = 32 + 3 * 64 + 48;
+
+    // a row count that wraps rows * sizeof(int) around to the column size
+    write_orders(path, 10);
+    patch_u64(path, 16, 10 + (std::uint64_t(1) << 62));
+    expect_open_error(path, "size mismatch");
+
+    // a file of the other byte order
+    write_orders(path, 10);
+    patch_u64(path, 24, 0x04030201);
+    expect_open_error(path, "byte order mismatch");
+
+    // string end offsets not starting at 0, checked by open()
+    write_orders(path, 10);
+    const std::uint64_t ends = read_u64(path, note_offset);
+    patch_u64(path, std::streamoff(ends), 1);
+    expect_open_error(path, "string column offsets corrupt");
+
+    // decreasing, or past the characters: checked on access
+    write_orders(path, 10);
+    patch_u64(path, std::streamoff(ends + 3 * 8), 100);
+    {
+        auto t = table_t::open(path);
+        EXPECT_EQ(t["note"_][1], "n");
+        EXPECT_THROW(t["note"_][2], std::exception);
+        EXPECT_THROW(t["note"_][3], std::exception);
+        EXPECT_THROW(t.to_tuple(3), std::exception);
+        EXPECT_EQ(t["note"_][4], "nnnn");
+    }
+
+    write_orders(path, 10);
+    EXPECT_EQ(table_t::open(path)["note"_][9], "nn");
+    std::remove(path.c_str());
+}
@@ -0,0 +1,128 @@
+#include <named_csv.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<nvt::fixed_string<4>, decltype("venue"_)>,
+                     nvt::named_value<bool, decltype("buy"_)>>;
+
+static std::string make_orders(int rows) {
+    std::string out;
+    nvt::csv_header<order_t>(out);
+    for (int i = 0; i < rows; ++i) {
+        order_t o{("id"_, i), ("px"_, i * 0.25), ("buy"_, i % 3 == 0)};
+        o["sym"_] = i % 5 ? "AAPL" : "say \"hi\", bye";
+        o["venue"_].get() = "XN";
+        nvt::to_csv(o, out);
+    }
+    return out;
+}
+
+static std::string line(const order_t& o) {
+    std::string out;
+    return nvt::to_csv(o, out);
+}
+
+TEST(NamedCsv, WriteAndRead) {
+    std::string out;
+    EXPECT_EQ(nvt::csv_header<order_t>(out), "id,sym,px,venue,buy\n");
+    order_t o{("id"_, 7), ("px"_, 10.5), ("buy"_, true)};
+    o["sym"_] = "a,\"b\"";
+    o["venue"_].get() = "XNYS";
+    nvt::to_csv(o, out);
+    EXPECT_EQ(out, "id,sym,px,venue,buy\n7,\"a,\"\"b\"\"\",10.5,XNYS,true\n");
+
+    std::vector<order_t> rows;
+    EXPECT_EQ(nvt::read_csv<order_t>(
+                  out, [&](const order_t& r) { rows.push_back(r); }),
+              1u);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(line(rows[0]), line(o));
+
+    // NaN and infinity are written as nan and inf, not as empty cells
+    rows.clear();
+    order_t special{("id"_, 8),
+                    ("px"_, std::numeric_limits<double>::quiet_NaN())};
+    EXPECT_EQ(line(special), "8,,nan,,false\n");
+    std::string text;
+    nvt::csv_header<order_t>(text);
+    nvt::to_csv(special, text);
+    special["px"_] = -std::numeric_limits<double>::infinity();
+    nvt::to_csv(special, text);
+    nvt::read_csv<order_t>(text,
+                           [&](const order_t& r) { rows.push_back(r); });
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_TRUE(std::isnan(rows[0]["px"_].get()));
+    EXPECT_EQ(rows[1]["px"_].get(), -std::numeric_limits<double>::infinity());
+}
+
+TEST(NamedCsv, HeaderMapping) {
+    // columns in another order, an unknown column, a missing field, CRLF
+    const std::string text =
+        "buy,extra,px,id,sym\r\n"
+        "1,x,1.5,3,\"IBM\"\r\n"
+        "\r\n"
+        "false,\"y,z\",,4,MSFT";
+    std::vector<order_t> rows;
+    nvt::read_csv<order_t>(text, [&](const order_t& r) { rows.push_back(r); });
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0]["id"_].get(), 3);
+    EXPECT_EQ(rows[0]["sym"_].get(), "IBM");
+    EXPECT_EQ(rows[0]["px"_].get(), 1.5);
+    EXPECT_TRUE(rows[0]["buy"_].get());
+    EXPECT_EQ(rows[0]["venue"_].get(), "");
+    EXPECT_EQ(rows[1]["px"_].get(), 0.0);
+    EXPECT_EQ(rows[1]["sym"_].get(), "MSFT");
+
+    EXPECT_THROW(nvt::read_csv<order_t>("id,px\n1,abc\n",
+                                        [](const order_t&) {}),
+                 std::exception);
+    EXPECT_THROW(nvt::read_csv<order_t>("id,px\n1\n", [](const order_t&) {}),
+                 std::exception);
+    EXPECT_THROW(nvt::read_csv<order_t>("id,id\n1,2\n",
+                                        [](const order_t&) {}),
+                 std::exception);
+    EXPECT_THROW(nvt::read_csv<order_t>("venue\nTOOLONG\n",
+                                        [](const order_t&) {}),
+                 std::exception);
+}
+
+TEST(NamedCsv, StreamParallelAndTable) {
+    const std::string text = make_orders(20000);
+
+    std::vector<order_t> rows;
+    std::istringstream in{text};
+    EXPECT_EQ(nvt::read_csv<order_t>(
+                  in, [&](const order_t& r) { rows.push_back(r); }, 4096),
+              20000u);
+    ASSERT_EQ(rows.size(), 20000u);
+    EXPECT_EQ(rows[15]["sym"_].get(), "say \"hi\", bye");
+    EXPECT_EQ(rows[19999]["id"_].get(), 19999);
+
+    std::atomic<long> ids{0};
+    EXPECT_EQ(nvt::read_csv_parallel<order_t>(
+                  text, [&](const order_t& r) { ids += r["id"_].get(); }, 4),
+              20000u);
+    EXPECT_EQ(ids.load(), 19999L * 20000 / 2);
+
+    const auto table = nvt::read_csv_table<order_t>(text, 4);
+    ASSERT_EQ(table.size(), 20000u);
+    for (std::size_t i = 0; i < table.size(); ++i)
+        ASSERT_EQ(line(table.to_tuple(i)), line(rows[i]));
+
+    std::string out;
+    EXPECT_EQ(nvt::to_csv(table, out), text);
+}
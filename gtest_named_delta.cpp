@@ -0,0 +1,122 @@
+
+#include <named_delta.h>
+#include <named_serialize.h>
+#include <named_tuple.h>
+#include <sys/mman.h>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using level_t = nvt::named_tuple<nvt::named_value<double, decltype("px"_)>,
+                                 nvt::named_value<int, decltype("qty"_)>>;
+using book_t =
+    nvt::named_tuple<nvt::named_value<std::uint64_t, decltype("seq"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<level_t, decltype("bid"_)>,
+                     nvt::named_value<level_t, decltype("ask"_)>,
+                     nvt::named_value<bool, decltype("halted"_)>>;
+
+TEST(NamedDelta, FieldMask) {
+    nvt::field_mask<70> m;
+    EXPECT_TRUE(m.none());
+    m.set(0).set(9).set(69);
+    EXPECT_EQ(m.count(), 3U);
+    std::vector<std::size_t> bits;
+    m.for_each_set([&](std::size_t i) { bits.push_back(i); });
+    EXPECT_EQ(bits, (std::vector<std::size_t>{0, 9, 69}));
+    EXPECT_EQ(m.byte(1), 2);
+    EXPECT_EQ(m.byte(8), 0x20);
+    m.set(9, false);
+    EXPECT_FALSE(m.test(9));
+    static_assert(nvt::field_mask<70>::byte_size == 9);
+}
+
+TEST(NamedDelta, DiffApply) {
+    book_t a{("seq"_, std::uint64_t(1)), ("sym"_, "IBM"),
+             ("bid"_, level_t{("px"_, 10.0), ("qty"_, 5)}),
+             ("ask"_, level_t{("px"_, 10.5), ("qty"_, 7)}),
+             ("halted"_, false)};
+    book_t b = a;
+    b["seq"_] = std::uint64_t(2);
+    b["ask"_].get()["qty"_] = 9;
+
+    auto patch = nvt::diff(a, b);
+    EXPECT_EQ(patch.mask().count(), 2U);
+    EXPECT_TRUE(patch.changed<decltype("seq"_)>());
+    EXPECT_TRUE(patch.changed<decltype("ask"_)>());
+    EXPECT_FALSE(patch.changed<decltype("bid"_)>());
+    EXPECT_TRUE(nvt::diff(a, a).mask().none());
+
+    book_t replica = a;
+    replica["sym"_] = "LOCAL";  // not in the patch, kept
+    nvt::apply(replica, patch);
+    std::stringstream strm;
+    strm << replica;
+    EXPECT_EQ(strm.str(),
+              "(seq: 2, sym: \"LOCAL\", bid: (px: 10, qty: 5), "
+              "ask: (px: 10.5, qty: 9), halted: 0)");
+}
+
+TEST(NamedDelta, WireEncoding) {
+    book_t a{("seq"_, std::uint64_t(1)), ("sym"_, "IBM")};
+    book_t b = a;
+    b["sym"_] = "MSFT";
+    b["halted"_] = true;
+    auto patch = nvt::diff(a, b);
+
+    std::vector<std::byte> buf;
+    EXPECT_TRUE(nvt::serialize(patch, nvt::vector_sink{buf}));
+    EXPECT_EQ(buf.size(), 1 + (4 + 4) + 1);
+    EXPECT_EQ(buf.size(), nvt::serialized_size(patch));
+    EXPECT_LT(buf.size(), nvt::serialized_size(b));
+
+    decltype(patch) decoded;
+    nvt::buffer_source src{buf};
+    ASSERT_TRUE(nvt::deserialize(src, decoded));
+    EXPECT_EQ(decoded.mask(), patch.mask());
+    nvt::apply(a, decoded);
+    EXPECT_EQ(a["sym"_].get(), "MSFT");
+    EXPECT_TRUE(a["halted"_].get());
+
+    buf[0] = std::byte{0x80};  // field 7 of 5
+    nvt::buffer_source bad{buf};
+    EXPECT_FALSE(nvt::deserialize(bad, decoded));
+    buf[0] = std::byte{0x12};
+    nvt::buffer_source truncated{buf.data(), 3};
+    EXPECT_FALSE(nvt::deserialize(truncated, decoded));
+    // a failed decode leaves the patch as it was
+    EXPECT_EQ(decoded.mask(), patch.mask());
+    EXPECT_EQ(decoded.values()["sym"_].get(), "MSFT");
+}
+
+TEST(NamedDelta, StringTooLong) {
+    // a masked 4 GiB string does not fit the uint32_t length: the mapping is
+    // never read, so its pages are not allocated
+    const std::size_t n = std::size_t(1) << 32;
+    void* m = ::mmap(nullptr, n, PROT_READ,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (m == MAP_FAILED) GTEST_SKIP() << "no 4 GiB address range";
+    const char* p = static_cast<const char*>(m);
+
+    using note_t =
+        nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                         nvt::named_value<std::string_view, decltype("note"_)>>;
+    const note_t a{("id"_, 1), ("note"_, std::string_view(p, n))};
+    note_t b = a;
+    b["id"_] = 2;
+    std::vector<std::byte> buf;
+    auto patch = nvt::diff(a, b);  // the long note is not masked
+    EXPECT_TRUE(nvt::serialize(patch, nvt::vector_sink{buf}));
+    EXPECT_EQ(buf.size(), 1u + 4);
+
+    buf.clear();
+    patch.set(("note"_, std::string_view(p, n)));
+    EXPECT_FALSE(nvt::serialize(patch, nvt::vector_sink{buf}));
+    EXPECT_TRUE(buf.empty());
+    ::munmap(m, n);
+}
@@ -0,0 +1,65 @@
+
+#include <named_format.h>
+#include <named_tuple.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+template<typename T>
+static std::string stream_text(const T& t) {
+    std::stringstream strm;
+    strm << t;
+    return strm.str();
+}
+
+template<typename T>
+static void expect_same_text(const T& t) {
+    char buf[1024];
+    auto r = nvt::format_to(buf, buf + sizeof(buf), t);
+    ASSERT_EQ(r.ec, std::errc{});
+    EXPECT_EQ(std::string(buf, r.ptr), stream_text(t));
+    EXPECT_LE(std::size_t(r.ptr - buf), nvt::format_size(t));
+    EXPECT_EQ(nvt::format(t), stream_text(t));
+}
+
+TEST(NamedFormat, MatchesStreamOutput) {
+    expect_same_text(nvt::named_tuple{("a"_, 123)});
+    expect_same_text(
+        nvt::named_tuple{("a"_, 1), ("b"_, 2.0), ("c"_, "the world")});
+    expect_same_text(nvt::named_tuple{("s"_, ""), ("t"_, "x")});
+    expect_same_text(nvt::named_tuple{
+        ("a"_, 123), ("b"_, nvt::named_tuple{("x"_, "test me")})});
+    expect_same_text(nvt::named_tuple{
+        ("i"_, -23), ("u"_, 18446744073709551615ULL), ("f"_, 0.1f),
+        ("d"_, 100.111), ("big"_, 123456789.0), ("small"_, 1e-5),
+        ("neg"_, -0.0), ("inf"_, HUGE_VAL), ("ld"_, 1.5L)});
+    expect_same_text(nvt::named_tuple{("flag"_, true), ("off"_, false),
+                                      ("c"_, 'Z'), ("sc"_, (signed char)65)});
+    expect_same_text(nvt::named_tuple{("addr"_, (void*)0xabcdef),
+                                      ("null"_, (void*)nullptr),
+                                      ("cstr"_, (const char*)"raw")});
+    expect_same_text(std::make_tuple(("a1"_, 33), 5, std::string("plain"),
+                                     std::make_tuple(1, 2, 3, "four", 5.5)));
+    expect_same_text(nvt::named_tuple{("f1"_, 123),
+                                      ("sub"_, nvt::named_tuple{("s1"_, 345),
+                                                                ("s2"_, "z")}),
+                                      ("f3"_, "test me")});
+}
+
+TEST(NamedFormat, BufferTooSmall) {
+    auto t = nvt::named_tuple{("name"_, "a longer string value"), ("x"_, 1)};
+    const auto text = stream_text(t);
+    char buf[64];
+    for (std::size_t n = 0; n < text.size(); ++n) {
+        auto r = nvt::format_to(buf, buf + n, t);
+        EXPECT_EQ(r.ec, std::errc::value_too_large);
+        EXPECT_EQ(r.ptr, buf + n);
+    }
+    auto r = nvt::format_to(buf, buf + text.size(), t);
+    EXPECT_EQ(r.ec, std::errc{});
+    EXPECT_EQ(std::string(buf, r.ptr), text);
+}
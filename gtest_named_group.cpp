@@ -0,0 +1,108 @@
+#include <named_group.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using fill_t =
+    nvt::named_tuple<nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<char, decltype("side"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<double, decltype("px"_)>>;
+
+// the grouping keeps a pointer to the rows, temporaries are rejected
+template<typename Rows>
+constexpr bool groups_rows = requires(Rows&& rows) {
+    nvt::group_by<"sym"_>(std::forward<Rows>(rows));
+};
+static_assert(groups_rows<const std::vector<fill_t>&>);
+static_assert(!groups_rows<std::vector<fill_t>>);
+static_assert(!std::is_constructible<
+              nvt::grouping<std::vector<fill_t>, "sym"_>,
+              std::vector<fill_t>>::value);
+
+static std::vector<fill_t> make_fills() {
+    return {fill_t{("sym"_, std::string("IBM")), ("side"_, 'B'),
+                   ("qty"_, 100), ("px"_, 10.5)},
+            fill_t{("sym"_, std::string("AAPL")), ("side"_, 'S'),
+                   ("qty"_, 50), ("px"_, 20.0)},
+            fill_t{("sym"_, std::string("IBM")), ("side"_, 'S'),
+                   ("qty"_, 200), ("px"_, 10.25)},
+            fill_t{("sym"_, std::string("IBM")), ("side"_, 'B'),
+                   ("qty"_, 300), ("px"_, 11.0)}};
+}
+
+TEST(NamedGroup, HashAggregation) {
+    const auto fills = make_fills();
+    const auto report = nvt::group_by<"sym"_>(fills).agg(
+        nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::min<"px"_>, nvt::count);
+
+    static_assert(decltype(report)::column_count() == 5);
+    EXPECT_EQ(std::string(report.names()[1]), "qty_sum");
+    EXPECT_EQ(std::string(report.names()[2]), "px_max");
+    EXPECT_EQ(std::string(report.names()[3]), "px_min");
+    EXPECT_EQ(std::string(report.names()[4]), "count");
+    static_assert(std::is_same<decltype(report["qty_sum"_][0]),
+                               const std::int64_t&>::value);
+
+    // groups in the order of their first row
+    ASSERT_EQ(report.size(), 2u);
+    EXPECT_EQ(report["sym"_][0], "IBM");
+    EXPECT_EQ(report["qty_sum"_][0], 600);
+    EXPECT_EQ(report["px_max"_][0], 11.0);
+    EXPECT_EQ(report["px_min"_][0], 10.25);
+    EXPECT_EQ(report["count"_][0], 3u);
+    EXPECT_EQ(report["sym"_][1], "AAPL");
+    EXPECT_EQ(report["count"_][1], 1u);
+
+    // composite key, sorted path, groups in key order
+    const auto by_side = nvt::group_by<"sym"_, "side"_>(fills).sorted().agg(
+        nvt::sum<"qty"_>, nvt::count);
+    ASSERT_EQ(by_side.size(), 3u);
+    EXPECT_EQ(by_side["sym"_][0], "AAPL");
+    EXPECT_EQ(by_side["sym"_][1], "IBM");
+    EXPECT_EQ(by_side["side"_][1], 'B');
+    EXPECT_EQ(by_side["qty_sum"_][1], 400);
+    EXPECT_EQ(by_side["side"_][2], 'S');
+    EXPECT_EQ(by_side["count"_][2], 1u);
+}
+
+TEST(NamedGroup, ParallelTableInput) {
+    nvt::table_for_t<fill_t> fills;
+    for (int i = 0; i < 200000; ++i) {
+        std::string sym{"S"};
+        fills.push_back(fill_t{("sym"_, sym += std::to_string(i % 1000)),
+                               ("side"_, i % 3 ? 'B' : 'S'), ("qty"_, i),
+                               ("px"_, double(i % 7))});
+    }
+
+    const auto serial = nvt::group_by<"sym"_>(fills).threads(1).agg(
+        nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count);
+    const auto parallel = nvt::group_by<"sym"_>(fills).threads(4).agg(
+        nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count);
+    const auto sorted = nvt::group_by<"sym"_>(fills).sorted().agg(
+        nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count);
+
+    ASSERT_EQ(serial.size(), 1000u);
+    ASSERT_EQ(parallel.size(), 1000u);
+    ASSERT_EQ(sorted.size(), 1000u);
+    for (std::size_t g = 0; g < serial.size(); ++g) {
+        EXPECT_EQ(parallel["sym"_][g], serial["sym"_][g]);
+        EXPECT_EQ(parallel["qty_sum"_][g], serial["qty_sum"_][g]);
+        EXPECT_EQ(parallel["px_max"_][g], serial["px_max"_][g]);
+        EXPECT_EQ(parallel["count"_][g], 200u);
+    }
+    // S0 is the first group of both; S1 sorts after S0 ... S100 ... S199
+    EXPECT_EQ(serial["sym"_][1], "S1");
+    EXPECT_EQ(sorted["sym"_][1], "S1");
+    EXPECT_EQ(sorted["sym"_][2], "S10");
+    std::int64_t total = 0;
+    for (std::int64_t s : sorted["qty_sum"_]) total += s;
+    EXPECT_EQ(total, 199999LL * 200000 / 2);
+}
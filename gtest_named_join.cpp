@@ -0,0 +1,101 @@
+#include <named_join.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<std::string, decltype("note"_)>>;
+using ref_t =
+    nvt::named_tuple<nvt::named_value<nvt::fixed_string<8>, decltype("sym"_)>,
+                     nvt::named_value<std::string, decltype("venue"_)>,
+                     nvt::named_value<int, decltype("lot"_)>,
+                     nvt::named_value<std::string, decltype("note"_)>>;
+
+// the left fields, then the right fields not in the left tuple
+static_assert(
+    std::is_same<nvt::join_tuple_t<order_t, ref_t>,
+                 nvt::named_tuple<
+                     nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<std::string, decltype("note"_)>,
+                     nvt::named_value<std::string, decltype("venue"_)>,
+                     nvt::named_value<int, decltype("lot"_)>>>::value);
+
+static nvt::table_for_t<ref_t> make_refdata() {
+    nvt::table_for_t<ref_t> refdata;
+    const char* const syms[]{"AAPL", "MSFT", "IBM", "IBM"};
+    const char* const venues[]{"XNAS", "XNAS", "XNYS", "ARCA"};
+    for (int i = 0; i < 4; ++i) {
+        ref_t r{("venue"_, std::string(venues[i])), ("lot"_, 100 * (i + 1)),
+                ("note"_, std::string("ref"))};
+        r["sym"_].get() = syms[i];
+        refdata.push_back(r);
+    }
+    return refdata;
+}
+
+TEST(NamedJoin, JoinTable) {
+    nvt::table_for_t<order_t> orders;
+    const char* const syms[]{"IBM", "GOOG", "AAPL", "IBM"};
+    for (int i = 0; i < 4; ++i)
+        orders.push_back(order_t{("id"_, i), ("sym"_, std::string(syms[i])),
+                                 ("qty"_, 10 * i),
+                                 ("note"_, std::string("order"))});
+
+    const auto out = nvt::join_table<"sym"_>(orders, make_refdata());
+    // IBM matches two reference rows, GOOG none
+    ASSERT_EQ(out.size(), 5u);
+    EXPECT_EQ(out["id"_][0], 0);
+    EXPECT_EQ(out["venue"_][0], "XNYS");
+    EXPECT_EQ(out["venue"_][1], "ARCA");
+    EXPECT_EQ(out["id"_][2], 2);
+    EXPECT_EQ(out["lot"_][2], 100);
+    EXPECT_EQ(out["id"_][4], 3);
+    EXPECT_EQ(out["sym"_][4], "IBM");
+    EXPECT_EQ(out["note"_][4], "order");  // the left value of a shared name
+}
+
+TEST(NamedJoin, ParallelBatches) {
+    nvt::table_for_t<order_t> orders;
+    const char* const syms[]{"IBM", "GOOG", "AAPL", "MSFT"};
+    for (int i = 0; i < 100000; ++i)
+        orders.push_back(order_t{("id"_, i),
+                                 ("sym"_, std::string(syms[i % 4])),
+                                 ("qty"_, 1)});
+    const auto refdata = make_refdata();
+
+    std::mutex mutex;
+    std::size_t batches = 0;
+    long lots = 0;
+    std::atomic<std::size_t> rows{0};
+    const std::size_t n = nvt::join<"sym"_>(
+        orders, refdata,
+        [&](const auto& batch) {
+            EXPECT_LE(batch.size(), 1000u);
+            rows += batch.size();
+            long sum = 0;
+            for (int lot : batch["lot"_]) sum += lot;
+            std::lock_guard<std::mutex> lock(mutex);
+            ++batches;
+            lots += sum;
+        },
+        4, 1000);
+    // IBM x2, AAPL x1, MSFT x1 per 4 orders
+    EXPECT_EQ(n, 100000u);
+    EXPECT_EQ(rows.load(), n);
+    EXPECT_GE(batches, 100u);
+    EXPECT_EQ(lots, 25000L * (300 + 400 + 100 + 200));
+
+    EXPECT_EQ(nvt::join_table<"sym"_>(orders, refdata).size(), n);
+}
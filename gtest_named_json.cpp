@@ -0,0 +1,108 @@
+
+#include <named_json.h>
+#include <named_tuple.h>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using book_t =
+    nvt::named_tuple<nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<std::string, decltype("venue"_)>>;
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<bool, decltype("live"_)>,
+                     nvt::named_value<book_t, decltype("book"_)>,
+                     nvt::named_value<uint64_t, decltype("qty"_)>>;
+
+TEST(NamedJson, NameIndex) {
+    using index = nvt::name_index<decltype("id"_), decltype("sym"_),
+                                  decltype("live"_), decltype("book"_)>;
+    static_assert(index::find("id") == 0);
+    static_assert(index::find("book") == 3);
+    static_assert(index::find("boo") == -1);
+    EXPECT_EQ(index::find(std::string("live")), 2);
+    EXPECT_EQ(index::find(""), -1);
+    EXPECT_EQ(nvt::name_index<>::find("x"), -1);
+}
+
+TEST(NamedJson, ToJson) {
+    order_t o{("id"_, 7), ("sym"_, "A\"B\\\n"), ("live"_, true),
+              ("book"_, book_t{("px"_, 10.5), ("venue"_, "XNAS")}),
+              ("qty"_, uint64_t(100))};
+    std::string out = "prefix ";
+    nvt::to_json(o, out);
+    EXPECT_EQ(out,
+              "prefix {\"id\":7,\"sym\":\"A\\\"B\\\\\\n\",\"live\":true,"
+              "\"book\":{\"px\":10.5,\"venue\":\"XNAS\"},\"qty\":100}");
+    EXPECT_EQ(nvt::to_json(nvt::named_tuple{("d"_, 0.1), ("c"_, 'x')}),
+              "{\"d\":0.1,\"c\":\"x\"}");
+}
+
+TEST(NamedJson, RoundTrip) {
+    order_t o{("id"_, -3), ("sym"_, "tab\there é"), ("live"_, false),
+              ("book"_, book_t{("px"_, 1e-7), ("venue"_, "")}),
+              ("qty"_, uint64_t(18446744073709551615ULL))};
+    auto o2 = nvt::from_json<order_t>(nvt::to_json(o));
+    std::stringstream s1, s2;
+    s1 << o;
+    s2 << o2;
+    EXPECT_EQ(s1.str(), s2.str());
+    EXPECT_EQ(o2["book"_].get()["px"_].get(), 1e-7);
+
+    // non finite values are written as null and read back as NaN
+    using px_t = nvt::named_tuple<nvt::named_value<double, decltype("px"_)>>;
+    const px_t inf{("px"_, std::numeric_limits<double>::infinity())};
+    EXPECT_EQ(nvt::to_json(inf), "{\"px\":null}");
+    EXPECT_TRUE(
+        std::isnan(nvt::from_json<px_t>(nvt::to_json(inf))["px"_].get()));
+}
+
+TEST(NamedJson, FromJsonUnknownAndMissingKeys) {
+    auto o = nvt::from_json<order_t>(
+        " { \"extra\" : {\"a\":[1,2,{\"b\":\"}\"}],\"c\":null},"
+        "\"sym\":\"IBM\\u0041\\ud83d\\ude00\", \"id\" : 12,"
+        "\"more\":[], \"book\":{\"px\":2.5,\"zz\":true}} ");
+    EXPECT_EQ(o["id"_].get(), 12);
+    EXPECT_EQ(o["sym"_].get(), "IBMA\xf0\x9f\x98\x80");
+    EXPECT_EQ(o["book"_].get()["px"_].get(), 2.5);
+    EXPECT_EQ(o["book"_].get()["venue"_].get(), "");
+    EXPECT_EQ(o["qty"_].get(), 0U);
+    EXPECT_FALSE(o["live"_].get());
+}
+
+TEST(NamedJson, Errors) {
+    for (auto text : {"", "{", "{\"id\":}", "{\"id\":1.5}", "{\"id\":\"1\"}",
+                      "{\"live\":1}", "{\"id\":1,}", "{\"id\":1} x",
+                      "{\"sym\":\"abc}", "[1]", "{\"id\":+1}"}) {
+        EXPECT_THROW(nvt::from_json<order_t>(text), std::exception) << text;
+    }
+    try {
+        nvt::from_json<order_t>("{\"id\":1 \"sym\":\"x\"}");
+        FAIL();
+    } catch (std::exception& e) {
+        EXPECT_NE(std::string(e.what()).find("offset: 8"), std::string::npos)
+            << e.what();
+    }
+
+    // deeply nested values of an unknown key fail, they do not overflow the
+    // stack
+    const std::string deep = "{\"x\":" + std::string(100000, '[');
+    try {
+        nvt::from_json<order_t>(deep);
+        FAIL();
+    } catch (std::exception& e) {
+        EXPECT_NE(std::string(e.what()).find("nesting too deep"),
+                  std::string::npos)
+            << e.what();
+    }
+    const std::string nested = "{\"x\":" + std::string(200, '[') +
+                               std::string(200, ']') + ",\"id\":3}";
+    EXPECT_EQ(nvt::from_json<order_t>(nested)["id"_].get(), 3);
+}
@@ -0,0 +1,122 @@
+
+#include <named_logger.h>
+#include <named_tuple.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using fill_t = nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                                nvt::named_value<double, decltype("px"_)>>;
+using note_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::string, decltype("text"_)>>;
+
+TEST(NamedLogger, SchemaId) {
+    static_assert(nvt::schema_id<fill_t> != nvt::schema_id<note_t>);
+    using other_t = nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                                     nvt::named_value<float, decltype("px"_)>>;
+    static_assert(nvt::schema_id<fill_t> != nvt::schema_id<other_t>);
+    // same names and sizes, different value types
+    using int_t = nvt::named_tuple<nvt::named_value<int, decltype("x"_)>>;
+    using float_t = nvt::named_tuple<nvt::named_value<float, decltype("x"_)>>;
+    using uint_t =
+        nvt::named_tuple<nvt::named_value<unsigned, decltype("x"_)>>;
+    static_assert(nvt::schema_id<int_t> != nvt::schema_id<float_t>);
+    static_assert(nvt::schema_id<int_t> != nvt::schema_id<uint_t>);
+    using nested_t = nvt::named_tuple<nvt::named_value<int_t, decltype("x"_)>>;
+    static_assert(nvt::schema_id<int_t> != nvt::schema_id<nested_t>);
+    static_assert(nvt::schema_id<fill_t> ==
+                  nvt::schema_id<nvt::named_tuple<
+                      nvt::named_value<int, decltype("id"_)>,
+                      nvt::named_value<double, decltype("px"_)>>>);
+}
+
+TEST(NamedLogger, TextFromThreads) {
+    std::stringstream out;
+    {
+        nvt::logger log{out};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&log, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    EXPECT_TRUE(log.log(fill_t{("id"_, t * 1000 + i),
+                                               ("px"_, 0.5)}));
+                }
+                log.log(note_t{("id"_, t), ("text"_, "done")});
+            });
+        for (auto& t : threads) t.join();
+        log.flush();
+        EXPECT_EQ(log.dropped(), 0U);
+    }
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(out, line);) lines.push_back(line);
+    EXPECT_EQ(lines.size(), 4004U);
+    EXPECT_EQ(std::count(lines.begin(), lines.end(),
+                         "(id: 2, text: \"done\")"),
+              1);
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "(id: 3999, px: 0.5)"),
+              lines.end());
+}
+
+TEST(NamedLogger, RingsOfExitedThreadsReused) {
+    std::stringstream out;
+    nvt::logger log{out};
+    for (int t = 0; t < 20; ++t)
+        std::thread([&log, t] {
+            EXPECT_TRUE(log.log(fill_t{("id"_, t), ("px"_, 0.5)}));
+        }).join();
+    EXPECT_EQ(log.ring_count(), 1U);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t)
+        threads.emplace_back([&log] {
+            for (int i = 0; i < 1000; ++i)
+                log.log(fill_t{("id"_, i), ("px"_, 1.5)});
+        });
+    for (auto& t : threads) t.join();
+    EXPECT_LE(log.ring_count(), 3U);
+    log.flush();
+    EXPECT_EQ(log.dropped(), 0U);
+    std::size_t lines = 0;
+    for (std::string line; std::getline(out, line);) ++lines;
+    EXPECT_EQ(lines, 3020U);
+
+    // one slot per thread, whatever the constructor arguments of local()
+    nvt::thread_slots<int> slots;
+    slots.local(1) = 5;
+    EXPECT_EQ(slots.local(short(2)), 5);
+    EXPECT_EQ(slots.local(), 5);
+    EXPECT_EQ(slots.size(), 1U);
+}
+
+TEST(NamedLogger, BinaryAndDrops) {
+    std::stringstream out;
+    nvt::logger log{out, nvt::logger::output::binary, 256};
+    std::size_t logged = 0;
+    for (int i = 0; i < 100000; ++i)
+        logged += log.log(fill_t{("id"_, i), ("px"_, 1.0)});
+    log.flush();
+    EXPECT_EQ(logged + log.dropped(), 100000U);
+    EXPECT_GT(log.dropped(), 0U);
+
+    const std::string bytes = out.str();
+    const std::size_t record = 8 + 4 + nvt::serialized_size_v<fill_t>;
+    ASSERT_EQ(bytes.size(), logged * record);
+    std::uint64_t id;
+    std::uint32_t size;
+    std::memcpy(&id, bytes.data(), sizeof(id));
+    std::memcpy(&size, bytes.data() + 8, sizeof(size));
+    EXPECT_EQ(id, nvt::schema_id<fill_t>);
+    EXPECT_EQ(size, nvt::serialized_size_v<fill_t>);
+    auto f = nvt::deserialize<fill_t>(nvt::buffer_source{
+        reinterpret_cast<const std::byte*>(bytes.data() + 12), size});
+    ASSERT_TRUE(f);
+    EXPECT_EQ((*f)["id"_].get(), 0);
+}
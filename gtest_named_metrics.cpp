@@ -0,0 +1,78 @@
+
+#include <named_metrics.h>
+#include <named_tuple.h>
+#include <iostream>
+#include <latch>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using pipeline_t = nvt::named_tuple<
+    nvt::named_value<std::uint64_t, decltype("msgs_in"_)>,
+    nvt::named_value<std::int64_t, decltype("bytes"_)>,
+    nvt::named_value<nvt::histogram, decltype("latency_ns"_)>>;
+
+TEST(NamedMetrics, Histogram) {
+    nvt::histogram h;
+    EXPECT_EQ(h.percentile(0.5), 0U);
+    for (std::uint64_t v : {0, 1, 2, 3, 100, 1000}) h.record(v);
+    EXPECT_EQ(h.count(), 6U);
+    EXPECT_EQ(h.sum(), 1106U);
+    EXPECT_EQ(h.bucket(nvt::histogram::bucket_of(3)), 2U);
+    EXPECT_EQ(h.percentile(0.5), 3U);
+    EXPECT_EQ(h.percentile(1.0), 1023U);
+    std::stringstream strm;
+    strm << h;
+    EXPECT_EQ(strm.str(), "(count: 6, sum: 1106, p50: 3, p99: 127, max: 1023)");
+}
+
+TEST(NamedMetrics, ShardsPerThread) {
+    nvt::metrics<pipeline_t> m;
+    std::vector<std::thread> threads;
+    std::latch running{4};  // the 4 threads hold their shards together
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&m, &running] {
+            for (int i = 0; i < 10000; ++i) {
+                m.add<"msgs_in"_>();
+                m.add<"bytes"_>(64);
+                m.record<"latency_ns"_>(100 + i % 100);
+            }
+            running.arrive_and_wait();
+        });
+    for (auto& t : threads) t.join();
+    m.add<"msgs_in"_>(5);  // reuses the shard of an exited thread
+    EXPECT_EQ(m.shard_count(), 4U);
+
+    pipeline_t total = m.collect();
+    EXPECT_EQ(total["msgs_in"_].get(), 40005U);
+    EXPECT_EQ(total["bytes"_].get(), 40000 * 64);
+    EXPECT_EQ(total["latency_ns"_].get().count(), 40000U);
+    EXPECT_EQ(total["latency_ns"_].get().percentile(0.99), 255U);
+
+    std::stringstream strm;
+    strm << total;
+    EXPECT_EQ(strm.str(),
+              "(msgs_in: 40005, bytes: 2560000, latency_ns: (count: 40000, "
+              "sum: 5980000, p50: 255, p99: 255, max: 255))");
+
+    int fields = 0;
+    total.foreach ([&](auto&) { ++fields; });
+    EXPECT_EQ(fields, 3);
+}
+
+TEST(NamedMetrics, ShardsOfExitedThreadsReused) {
+    nvt::metrics<pipeline_t> m;
+    for (int t = 0; t < 50; ++t)
+        std::thread([&m] {
+            m.add<"msgs_in"_>();
+            m.record<"latency_ns"_>(7);
+        }).join();
+    EXPECT_EQ(m.shard_count(), 1U);
+    const pipeline_t total = m.collect();
+    EXPECT_EQ(total["msgs_in"_].get(), 50U);
+    EXPECT_EQ(total["latency_ns"_].get().count(), 50U);
+}
@@ -0,0 +1,72 @@
+
+#include <named_overlay.h>
+#include <named_tuple.h>
+#include <iostream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+NVT_FIELD_TYPE("seq"_, uint32_t)
+NVT_FIELD_ENDIAN("seq"_, std::endian::big)
+NVT_FIELD_TYPE("px"_, double)
+
+using msg_t = nvt::named_tuple<nvt::named_value<uint32_t, decltype("seq"_)>,
+                               nvt::named_value<char, decltype("side"_)>,
+                               nvt::named_value<double, decltype("px"_)>,
+                               nvt::named_value<uint16_t, decltype("qty"_)>>;
+
+TEST(NamedOverlay, PackedOffsets) {
+    using ov_t = nvt::overlay_for_t<msg_t>;
+    static_assert(ov_t::wire_size == 4 + 1 + 8 + 2);
+    static_assert(ov_t::offsets()[2] == 5);
+    EXPECT_EQ(std::string(ov_t::names()[3]), "qty");
+}
+
+TEST(NamedOverlay, ReadInPlace) {
+    const unsigned char wire[] = {0x00, 0x00, 0x01, 0x02,  // seq big endian
+                                  'B',                     // side
+                                  0,    0,    0,    0,    0, 0, 0, 0,  // px
+                                  0x10, 0x00};  // qty native (little) endian
+    std::byte buf[sizeof(wire)];
+    std::memcpy(buf, wire, sizeof(wire));
+    double px = 101.25;
+    std::memcpy(buf + 5, &px, sizeof(px));
+
+    nvt::overlay_for<msg_t>::const_type m{buf};
+    EXPECT_EQ(m["seq"_].get(), 0x0102U);
+    EXPECT_EQ(m["side"_].get(), 'B');
+    EXPECT_EQ(m["px"_].get(), 101.25);
+    uint16_t qty = m["qty"_];
+    if constexpr (std::endian::native == std::endian::little) {
+        EXPECT_EQ(qty, 0x10);
+    }
+
+    std::stringstream strm;
+    strm << m;
+    std::stringstream tstrm;
+    tstrm << m.to_tuple();
+    EXPECT_EQ(strm.str(), tstrm.str());
+}
+
+TEST(NamedOverlay, WriteInPlace) {
+    std::byte buf[nvt::overlay_for_t<msg_t>::wire_size]{};
+    nvt::overlay_for_t<msg_t> m{buf};
+    m["seq"_] = 0x0a0b0c0dU;
+    m["px"_] = 2.5;
+    EXPECT_EQ(buf[0], std::byte{0x0a});
+    EXPECT_EQ(buf[3], std::byte{0x0d});
+    EXPECT_EQ(m["seq"_].get(), 0x0a0b0c0dU);
+
+    m.store(nvt::named_tuple{("qty"_, uint16_t(7)), ("side"_, 'S')});
+    auto t = m.to_tuple();
+    EXPECT_EQ(t["seq"_].get(), 0x0a0b0c0dU);
+    EXPECT_EQ(t["side"_].get(), 'S');
+    EXPECT_EQ(t["px"_].get(), 2.5);
+    EXPECT_EQ(t["qty"_].get(), 7);
+
+    std::byte copy[sizeof(buf)];
+    nvt::overlay_for_t<msg_t>{copy}.store(t);
+    EXPECT_EQ(std::memcmp(copy, buf, sizeof(buf)), 0);
+}
@@ -0,0 +1,109 @@
+
+#include <named_query.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using trade_t = nvt::named_tuple<nvt::named_value<double, decltype("price"_)>,
+                                 nvt::named_value<int, decltype("qty"_)>>;
+
+static nvt::table_for_t<trade_t> make_trades(std::size_t n) {
+    nvt::table_for_t<trade_t> table;
+    for (std::size_t i = 0; i < n; ++i)
+        table.push_back(trade_t{("price"_, double((i * 37) % 101)),
+                                ("qty"_, int(i % 13) - 6)});
+    return table;
+}
+
+TEST(NamedQuery, ReduceWhereAllLevels) {
+    const auto table = make_trades(1000);
+
+    std::size_t count = 0;
+    std::int64_t sum = 0;
+    int mn = 100, mx = -100;
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        auto r = table.row(i);
+        if (r["price"_].get() > 50.0) {
+            ++count;
+            sum += r["qty"_].get();
+            mn = std::min(mn, r["qty"_].get());
+            mx = std::max(mx, r["qty"_].get());
+        }
+    }
+
+    for (auto level : {nvt::simd_level::avx512, nvt::simd_level::avx2,
+                       nvt::simd_level::scalar}) {
+        nvt::force_simd_level(nvt::detect_simd_level());
+        nvt::force_simd_level(level);
+        auto res =
+            nvt::reduce<"qty"_>(table, nvt::where<"price"_>(nvt::gt, 50));
+        EXPECT_TRUE((std::is_same<decltype(res.sum), std::int64_t>::value));
+        EXPECT_EQ(res.count, count);
+        EXPECT_EQ(res.sum, sum);
+        EXPECT_EQ(res.min, mn);
+        EXPECT_EQ(res.max, mx);
+        ASSERT_EQ(res.selection.size(), 16U);
+        for (std::size_t i = 0; i < table.size(); ++i)
+            EXPECT_EQ(res.selected(i), table["price"_][i] > 50.0);
+    }
+    nvt::force_simd_level(nvt::detect_simd_level());
+}
+
+TEST(NamedQuery, ReduceAllRowsAndEmpty) {
+    const auto table = make_trades(70);
+    auto res = nvt::reduce<"price"_>(table);
+    EXPECT_EQ(res.count, 70U);
+    double sum = 0;
+    for (auto p : table["price"_]) sum += p;
+    EXPECT_DOUBLE_EQ(res.sum, sum);
+    EXPECT_EQ(res.max, 100.0);
+
+    auto none = nvt::reduce<"price"_>(table, nvt::where<"qty"_>(nvt::gt, 100));
+    EXPECT_EQ(none.count, 0U);
+    EXPECT_EQ(none.sum, 0.0);
+    EXPECT_EQ(none.min, 0.0);
+    EXPECT_EQ(none.max, 0.0);
+}
+
+TEST(NamedQuery, ConstantOutsideKeyType) {
+    using row_t = nvt::named_tuple<nvt::named_value<int, decltype("qty"_)>,
+                                   nvt::named_value<float, decltype("px"_)>>;
+    nvt::table_for_t<row_t> table;
+    for (int i = 0; i < 20; ++i)
+        table.push_back(row_t{("qty"_, i), ("px"_, float(i) + 0.1f)});
+    const auto count = [&](auto pred) {
+        return nvt::reduce<"qty"_>(table, pred).count;
+    };
+
+    // a non integral constant against an int column
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::ge, 10.5)), 9U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::gt, 10.5)), 9U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::le, 10.5)), 11U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::lt, 10.5)), 11U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::eq, 10.5)), 0U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::ne, 10.5)), 20U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::eq, 10.0)), 1U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::gt, -0.5)), 20U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::lt, std::nan(""))), 0U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::ne, std::nan(""))), 20U);
+
+    // constants out of the int range
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::gt, -(1LL << 40))), 20U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::lt, -(1LL << 40))), 0U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::lt, 1LL << 40)), 20U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::eq, 1LL << 32)), 0U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::ge, 1e300)), 0U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::ge, -1e300)), 20U);
+    EXPECT_EQ(count(nvt::where<"qty"_>(nvt::le, 3000000000U)), 20U);
+
+    // a double constant between two float keys, and one beyond float
+    EXPECT_EQ(count(nvt::where<"px"_>(nvt::eq, 10.1)), 0U);
+    EXPECT_EQ(count(nvt::where<"px"_>(nvt::eq, double(10.1f))), 1U);
+    EXPECT_EQ(count(nvt::where<"px"_>(nvt::ge, 10.1)), 10U);
+    EXPECT_EQ(count(nvt::where<"px"_>(nvt::lt, 1e300)), 20U);
+    EXPECT_EQ(count(nvt::where<"px"_>(nvt::gt, 19)), 1U);
+}
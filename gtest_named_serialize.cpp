@@ -0,0 +1,91 @@
+
+#include <named_overlay.h>
+#include <named_serialize.h>
+#include <named_tuple.h>
+#include <sys/mman.h>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using quote_t = nvt::named_tuple<nvt::named_value<uint64_t, decltype("seq"_)>,
+                                 nvt::named_value<double, decltype("bid"_)>,
+                                 nvt::named_value<double, decltype("ask"_)>,
+                                 nvt::named_value<char, decltype("flag"_)>>;
+
+TEST(NamedSerialize, PodSchema) {
+    static_assert(nvt::is_trivially_serializable_v<quote_t>);
+    static_assert(nvt::serialized_size_v<quote_t> == 8 + 8 + 8 + 1);
+
+    quote_t q{("seq"_, uint64_t(42)), ("bid"_, 1.5), ("ask"_, 1.75),
+              ("flag"_, 'X')};
+    std::byte buf[64];
+    nvt::fixed_sink sink{buf, sizeof(buf)};
+    EXPECT_TRUE(nvt::serialize(q, sink));
+    EXPECT_TRUE(nvt::serialize(q, sink));
+    EXPECT_EQ(sink.size(), 2 * nvt::serialized_size_v<quote_t>);
+    EXPECT_FALSE(nvt::serialize(q, sink));  // no room for a third record
+
+    // the encoding of a trivially serializable schema is its overlay layout
+    nvt::overlay_for<quote_t>::const_type ov{buf};
+    EXPECT_EQ(ov["ask"_].get(), 1.75);
+    EXPECT_EQ(ov["flag"_].get(), 'X');
+
+    nvt::buffer_source src{sink.written()};
+    auto q1 = nvt::deserialize<quote_t>(src);
+    auto q2 = nvt::deserialize<quote_t>(src);
+    ASSERT_TRUE(q1 && q2);
+    EXPECT_FALSE(nvt::deserialize<quote_t>(src));
+    std::stringstream s0, s1;
+    s0 << q;
+    s1 << *q2;
+    EXPECT_EQ(s0.str(), s1.str());
+}
+
+TEST(NamedSerialize, StringsAndNested) {
+    auto t = nvt::named_tuple{
+        ("id"_, 7), ("sym"_, "AAPL"),
+        ("book"_, nvt::named_tuple{("px"_, 10.5), ("venue"_, "XNAS")}),
+        ("empty"_, "")};
+    using T = decltype(t);
+    static_assert(!nvt::is_trivially_serializable_v<T>);
+    EXPECT_EQ(nvt::serialized_size(t), 4 + (4 + 4) + 8 + (4 + 4) + 4U);
+
+    std::vector<std::byte> buf;
+    EXPECT_TRUE(nvt::serialize(t, nvt::vector_sink{buf}));
+    EXPECT_EQ(buf.size(), nvt::serialized_size(t));
+
+    auto d = nvt::deserialize<T>(nvt::buffer_source{buf});
+    ASSERT_TRUE(d);
+    std::stringstream s0, s1;
+    s0 << t;
+    s1 << *d;
+    EXPECT_EQ(s0.str(), s1.str());
+
+    // truncated input
+    for (std::size_t n = 0; n < buf.size(); ++n) {
+        EXPECT_FALSE(nvt::deserialize<T>(nvt::buffer_source{buf.data(), n}));
+    }
+}
+
+TEST(NamedSerialize, StringTooLong) {
+    // a 4 GiB string does not fit the uint32_t length: the mapping is never
+    // read, so its pages are not allocated
+    const std::size_t n = std::size_t(1) << 32;
+    void* m = ::mmap(nullptr, n, PROT_READ,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (m == MAP_FAILED) GTEST_SKIP() << "no 4 GiB address range";
+    const char* p = static_cast<const char*>(m);
+
+    nvt::named_tuple t{("id"_, 7), ("sym"_, std::string_view(p, n))};
+    std::vector<std::byte> buf;
+    EXPECT_FALSE(nvt::serialize(t, nvt::vector_sink{buf}));
+    EXPECT_TRUE(buf.empty());
+
+    t["sym"_] = std::string_view(p, n - 1);
+    EXPECT_EQ(nvt::serialized_size(t), 4 + 4 + (n - 1));
+    ::munmap(m, n);
+}
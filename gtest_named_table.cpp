@@ -0,0 +1,157 @@
+
+#include <named_table.h>
+#include <named_tuple.h>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<double, decltype("price"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>>;
+using order_table_t = nvt::table_for_t<order_t>;
+
+TEST(NamedTable, PushBackAndColumns) {
+    order_table_t table;
+    EXPECT_TRUE(table.empty());
+    table.push_back(nvt::named_tuple{("id"_, 1), ("price"_, 10.5),
+                                     ("sym"_, "AAPL")});
+    // matching names in a different order
+    table.push_back(nvt::named_tuple{("sym"_, "MSFT"), ("price"_, 20.25),
+                                     ("id"_, 2)});
+    EXPECT_EQ(table.size(), 2U);
+
+    auto prices = table["price"_];
+    EXPECT_TRUE((std::is_same<decltype(prices), std::span<double>>::value));
+    EXPECT_EQ(prices.size(), 2U);
+    EXPECT_EQ(prices[0], 10.5);
+    EXPECT_EQ(prices[1], 20.25);
+    EXPECT_EQ(table["sym"_][1], "MSFT");
+
+    prices[1] = 21.0;
+    EXPECT_EQ(table.column<decltype("price"_)>()[1], 21.0);
+
+    const auto& ctable = table;
+    EXPECT_TRUE((std::is_same<decltype(ctable["id"_]),
+                              std::span<const int>>::value));
+}
+
+TEST(NamedTable, RowProxy) {
+    order_table_t table;
+    table.push_back(order_t{("id"_, 7), ("price"_, 1.5), ("sym"_, "IBM")});
+
+    auto r = table.row(0);
+    EXPECT_EQ(r["id"_].get(), 7);
+    EXPECT_EQ(r.get<decltype("price"_)>().get(), 1.5);
+    EXPECT_EQ(std::string(r["sym"_].get_value_name()), "sym");
+
+    r["id"_] = 8;
+    r["sym"_] = "IBMX";
+    EXPECT_EQ(table["id"_][0], 8);
+    EXPECT_EQ(table["sym"_][0], "IBMX");
+
+    std::stringstream strm;
+    strm << table.row(0);
+    EXPECT_EQ(strm.str(), "(id: 8, price: 1.5, sym: \"IBMX\")");
+
+    std::stringstream tstrm;
+    tstrm << table.row(0).to_tuple();
+    EXPECT_EQ(strm.str(), tstrm.str());
+
+    EXPECT_EQ(std::string(r.names()[1]), "price");
+}
+
+TEST(NamedTable, RowForeach) {
+    order_table_t table(3);
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        table.row(i)["id"_] = int(i);
+    }
+    int count = 0;
+    table.row(2).foreach ([&](auto nr) {
+        ++count;
+        if constexpr (std::is_same<typename decltype(nr)::type, int>::value) {
+            EXPECT_EQ(nr.get(), 2);
+        }
+    });
+    EXPECT_EQ(count, 3);
+}
+
+TEST(NamedTable, ColumnIndexByName) {
+    static_assert(order_table_t::column_index("price") == 1);
+    EXPECT_EQ(order_table_t::column_index(std::string("sym")), 2);
+    EXPECT_EQ(order_table_t::column_index("id"), 0);
+    EXPECT_EQ(order_table_t::column_index("ids"), -1);
+    EXPECT_EQ(order_table_t::column_index(""), -1);
+}
+
+TEST(NamedTable, BoolColumn) {
+    using flag_t = nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                                    nvt::named_value<bool, decltype("live"_)>>;
+    nvt::table_for_t<flag_t> table;
+    for (int i = 0; i < 100; ++i)
+        table.push_back(flag_t{("id"_, i), ("live"_, i % 3 == 0)});
+
+    // one bool per row, viewed as a span like any other column
+    auto live = table["live"_];
+    EXPECT_TRUE((std::is_same<decltype(live), std::span<bool>>::value));
+    ASSERT_EQ(live.size(), 100U);
+    EXPECT_TRUE(live[99]);
+    EXPECT_FALSE(live[98]);
+    live[98] = true;
+    EXPECT_TRUE(table.row(98)["live"_].get());
+    EXPECT_TRUE(table.to_tuple(98)["live"_].get());
+
+    const auto copy = table;
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    ASSERT_EQ(copy.size(), 100U);
+    int count = 0;
+    for (bool b : copy["live"_]) count += b;
+    EXPECT_EQ(count, 35);
+
+    table.resize(3);
+    EXPECT_FALSE(table["live"_][2]);
+}
+
+// a value whose copy throws while fail is set
+struct flaky {
+    static inline bool fail = false;
+    int value{0};
+    flaky() = default;
+    flaky(int v) : value(v) {}
+    flaky(const flaky& o) : value(o.value) {
+        if (fail) throw std::runtime_error("flaky copy");
+    }
+    flaky(flaky&&) noexcept = default;
+    flaky& operator=(const flaky&) = default;
+    flaky& operator=(flaky&&) noexcept = default;
+};
+
+TEST(NamedTable, PushBackRollsBack) {
+    using row_t =
+        nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                         nvt::named_value<bool, decltype("live"_)>,
+                         nvt::named_value<flaky, decltype("note"_)>,
+                         nvt::named_value<double, decltype("px"_)>>;
+    nvt::table_for_t<row_t> table;
+    const row_t r{("id"_, 1), ("live"_, true), ("note"_, flaky{7}),
+                  ("px"_, 1.5)};
+    table.push_back(r);
+
+    flaky::fail = true;
+    EXPECT_THROW(table.push_back(r), std::runtime_error);
+    flaky::fail = false;
+    // the id and live columns appended before the throw are shrunk back
+    EXPECT_EQ(table.size(), 1U);
+    EXPECT_EQ(table.column<decltype("id"_)>().size(), 1U);
+    EXPECT_EQ(table.column<decltype("live"_)>().size(), 1U);
+    EXPECT_EQ(table.column<decltype("px"_)>().size(), 1U);
+
+    table.push_back(r);
+    EXPECT_EQ(table.size(), 2U);
+    EXPECT_EQ(table["note"_][1].value, 7);
+}
@@ -0,0 +1,86 @@
+
+#include <named_table.h>
+#include <named_tuple.h>
+#include <named_view.h>
+#include <iostream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<bool, decltype("live"_)>>;
+
+static double notional(nvt::project_t<const order_t, "px"_, "qty"_> v) {
+    return v["px"_].get() * v["qty"_].get();
+}
+
+TEST(NamedView, ProjectAndWriteThrough) {
+    order_t order{("id"_, 7), ("sym"_, "IBM"), ("px"_, 10.5), ("qty"_, 100),
+                  ("live"_, true)};
+    auto v = nvt::project<"px"_, "id"_>(order);
+    EXPECT_EQ(v.size(), 2U);
+    EXPECT_EQ(std::string(v.names()[0]), "px");
+    EXPECT_EQ(&v["px"_].get(), &order["px"_].get());
+
+    v["px"_] = 11.0;
+    EXPECT_EQ(order["px"_].get(), 11.0);
+
+    std::stringstream strm;
+    strm << v;
+    EXPECT_EQ(strm.str(), "(px: 11, id: 7)");
+
+    int n = 0;
+    v.foreach ([&](auto nr) { ++n, (void)nr; });
+    EXPECT_EQ(n, 2);
+
+    EXPECT_EQ(notional(nvt::project<"px"_, "qty"_>(std::as_const(order))),
+              1100.0);
+    auto cv = nvt::project<"sym"_>(std::as_const(order));
+    EXPECT_TRUE((std::is_same<decltype(cv["sym"_].get()),
+                              const std::string&>::value));
+}
+
+TEST(NamedView, CompareAndAssign) {
+    order_t a{("id"_, 1), ("sym"_, "IBM"), ("px"_, 10.0), ("qty"_, 5)};
+    order_t b{("id"_, 2), ("sym"_, "IBM"), ("px"_, 10.0), ("qty"_, 9)};
+    auto va = nvt::project<"sym"_, "px"_>(a);
+    auto vb = nvt::project<"px"_, "sym"_>(b);
+    EXPECT_TRUE(va == vb);
+    EXPECT_FALSE(nvt::project<"qty"_>(a) == nvt::project<"qty"_>(b));
+    EXPECT_TRUE(nvt::project<"qty"_>(a) < nvt::project<"qty"_>(b));
+    EXPECT_TRUE(
+        (nvt::project<"id"_, "qty"_>(b) > nvt::project<"id"_, "qty"_>(a)));
+
+    // a narrow tuple, by name
+    auto narrow = va.to_tuple();
+    EXPECT_TRUE(va == narrow);
+    EXPECT_TRUE(narrow == vb);
+    narrow["px"_] = 12.5;
+    EXPECT_TRUE(va < narrow);
+
+    // assign back to the source, from a tuple and from another view
+    va = narrow;
+    EXPECT_EQ(a["px"_].get(), 12.5);
+    EXPECT_EQ(a["id"_].get(), 1);
+    nvt::project<"qty"_>(a) = nvt::project<"qty"_>(b);
+    EXPECT_EQ(a["qty"_].get(), 9);
+
+    b << nvt::project<"px"_, "qty"_>(a);
+    EXPECT_EQ(b["px"_].get(), 12.5);
+}
+
+TEST(NamedView, TableRow) {
+    nvt::table_for_t<order_t> table;
+    table.push_back(order_t{("id"_, 1), ("px"_, 3.0)});
+    auto v = nvt::project<"px"_>(table.row(0));
+    v["px"_] = 4.0;
+    EXPECT_EQ(table["px"_][0], 4.0);
+    auto vv = nvt::project<"px"_>(v);
+    EXPECT_EQ(vv["px"_].get(), 4.0);
+}
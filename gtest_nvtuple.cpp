@@ -251,3 +251,35 @@ TEST(NamedValueTuple, FuncD_toString) {
     EXPECT_EQ(funcD(("a"_, 3), ("x"_, 3.6), ("z"_, "abc")),
               "(a: 3, x: 3.6, z: \"abc\")");
 }
+
+TEST(NamedValueTuple, VisitFieldByName) {
+    auto t = nvt::named_tuple{("id"_, 7), ("px"_, 2.5), ("sym"_, "IBM")};
+    static_assert(decltype(t)::field_index("px") == 1);
+    EXPECT_EQ(decltype(t)::field_index(std::string("sym")), 2);
+    EXPECT_EQ(decltype(t)::field_index("nope"), -1);
+
+    std::stringstream strm;
+    for (std::string name : {"sym", "id", "x", "px"}) {
+        bool found = t.visit_field(name, [&](auto& nv) { strm << nv << ';'; });
+        EXPECT_EQ(found, name != "x");
+    }
+    EXPECT_EQ(strm.str(), "sym: \"IBM\";id: 7;px: 2.5;");
+
+    t.visit_field("px", [](auto& nv) {
+        if constexpr (std::is_same_v<typename std::remove_reference_t<
+                                         decltype(nv)>::type,
+                                     double>)
+            nv = 4.0;
+    });
+    EXPECT_EQ(t["px"_].get(), 4.0);
+
+    const auto& ct = t;
+    int id = 0;
+    EXPECT_TRUE(ct.visit_field("id", [&](const auto& nv) {
+        if constexpr (std::is_same_v<typename std::remove_cvref_t<
+                                         decltype(nv)>::type,
+                                     int>)
+            id = nv.get();
+    }));
+    EXPECT_EQ(id, 7);
+}
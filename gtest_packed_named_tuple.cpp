@@ -0,0 +1,61 @@
+
+#include <named_tuple.h>
+#include <packed_named_tuple.h>
+#include <iostream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using order_t = nvt::named_tuple<nvt::named_value<char, decltype("side"_)>,
+                                 nvt::named_value<double, decltype("px"_)>,
+                                 nvt::named_value<char, decltype("tif"_)>,
+                                 nvt::named_value<int, decltype("qty"_)>,
+                                 nvt::named_value<double, decltype("stop"_)>,
+                                 nvt::named_value<short, decltype("venue"_)>>;
+using packed_order_t = nvt::packed_for_t<order_t>;
+
+// 8 + 8 + 4 + 2 + 1 + 1
+static_assert(packed_order_t::packed_size == 24);
+static_assert(packed_order_t::unpacked_size == 40);
+static_assert(packed_order_t::saved_bytes == 16);
+static_assert(sizeof(packed_order_t) == packed_order_t::packed_size);
+
+TEST(PackedNamedTuple, DeclaredOrderAccess) {
+    packed_order_t o{("px"_, 10.5), ("side"_, 'B'), ("qty"_, 100)};
+    o["venue"_] = short(3);
+    EXPECT_EQ(o["px"_].get(), 10.5);
+    EXPECT_EQ(o.get<decltype("side"_)>().get(), 'B');
+    EXPECT_EQ(std::string(o.names()[1]), "px");
+    EXPECT_EQ(packed_order_t::get_index<decltype("qty"_)>(), 3);
+    EXPECT_EQ(packed_order_t::field_index("stop"), 4);
+
+    o["tif"_] = 'D';
+    std::stringstream strm;
+    strm << o;
+    EXPECT_EQ(strm.str(),
+              "(side: B, px: 10.5, tif: D, qty: 100, stop: 0, venue: 3)");
+
+    std::string names;
+    o.foreach ([&](const auto& nv) { names += nv.get_value_name(); });
+    EXPECT_EQ(names, "sidepxtifqtystopvenue");
+
+    // the first stored field is the most aligned one
+    const auto px_slot = packed_order_t::slot()[1];
+    EXPECT_TRUE(px_slot == 0 || px_slot == 5);
+}
+
+TEST(PackedNamedTuple, ConvertToAndFromNamedTuple) {
+    order_t t{("side"_, 'S'), ("px"_, 1.25), ("tif"_, 'I'), ("qty"_, 7),
+              ("stop"_, 1.5), ("venue"_, short(2))};
+    packed_order_t p{t};
+    std::stringstream a, b;
+    a << t;
+    b << p;
+    EXPECT_EQ(a.str(), b.str());
+
+    p << nvt::named_tuple{("qty"_, 8)};
+    EXPECT_EQ(p.to_tuple()["qty"_].get(), 8);
+    EXPECT_EQ(p.to_tuple()["stop"_].get(), 1.5);
+}
@@ -0,0 +1,95 @@
+
+#define NVT_STRING_LITERAL_POLICY nvtuple_ns::literal_as_pmr_string
+
+#include <named_format.h>
+#include <named_json.h>
+#include <named_serialize.h>
+#include <named_tuple.h>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using leg_t =
+    nvt::named_tuple<nvt::named_value<std::pmr::string, decltype("venue"_)>,
+                     nvt::named_value<int, decltype("qty"_)>>;
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::pmr::string, decltype("sym"_)>,
+                     nvt::named_value<leg_t, decltype("leg"_)>>;
+using alloc_t = std::pmr::polymorphic_allocator<>;
+
+static_assert(std::uses_allocator<order_t, alloc_t>::value);
+static_assert(std::uses_allocator<leg_t, alloc_t>::value);
+static_assert(!std::uses_allocator<
+              nvt::named_tuple<nvt::named_value<int, decltype("id"_)>>,
+              alloc_t>::value);
+
+// longer than the small string buffer
+static const std::string long_str(64, 'x');
+static const std::string_view long_text{long_str};
+
+// an arena that fails on any allocation past its buffer
+struct arena {
+    std::byte buf[16 << 10];
+    std::pmr::monotonic_buffer_resource res{buf, sizeof(buf),
+                                            std::pmr::null_memory_resource()};
+    alloc_t alloc{&res};
+};
+
+TEST(PmrTuple, AllocatorExtendedConstruction) {
+    arena a;
+    order_t o(std::allocator_arg, a.alloc);
+    EXPECT_EQ(o["sym"_].get().get_allocator().resource(), &a.res);
+    EXPECT_EQ(o["leg"_].get()["venue"_].get().get_allocator().resource(),
+              &a.res);
+    o["sym"_] = long_str.c_str();
+    o["leg"_].get()["venue"_] = long_str.c_str();
+    EXPECT_EQ(o["sym"_].get(), long_text);
+
+    order_t copy(std::allocator_arg, a.alloc, o);
+    EXPECT_EQ(copy["leg"_].get()["venue"_].get(), long_text);
+    EXPECT_EQ(copy["sym"_].get().get_allocator().resource(), &a.res);
+
+    // the literal policy makes ("sym"_, "...") a std::pmr::string
+    auto nv = ("sym"_, "IBM");
+    EXPECT_TRUE((std::is_same<decltype(nv)::type, std::pmr::string>::value));
+    order_t named(std::allocator_arg, a.alloc, ("id"_, 7), nv);
+    EXPECT_EQ(named["sym"_].get(), "IBM");
+    EXPECT_EQ(named["sym"_].get().get_allocator().resource(), &a.res);
+}
+
+TEST(PmrTuple, PmrContainerOfRecords) {
+    arena a;
+    std::pmr::vector<order_t> orders(a.alloc);
+    orders.reserve(8);
+    for (int i = 0; i < 8; ++i) {
+        orders.emplace_back(("id"_, i));
+        orders.back()["sym"_] = long_str.c_str();
+    }
+    for (auto& o : orders) {
+        EXPECT_EQ(o["sym"_].get().get_allocator().resource(), &a.res);
+        EXPECT_EQ(o["leg"_].get()["venue"_].get().get_allocator().resource(),
+                  &a.res);
+    }
+
+    // printing, formatting and encodings handle std::pmr::string
+    std::stringstream strm;
+    strm << orders[3];
+    EXPECT_EQ(strm.str(), "(id: 3, sym: \"" + long_str +
+                              "\", leg: (venue: \"\", qty: 0))");
+    EXPECT_EQ(nvt::format(orders[3]), strm.str());
+    order_t back(std::allocator_arg, a.alloc);
+    nvt::from_json(nvt::to_json(orders[3]), back);
+    EXPECT_EQ(back["sym"_].get(), long_text);
+    std::vector<std::byte> buf;
+    nvt::serialize(orders[2], nvt::vector_sink{buf});
+    order_t decoded(std::allocator_arg, a.alloc);
+    nvt::buffer_source src{buf};
+    ASSERT_TRUE(nvt::deserialize(src, decoded));
+    EXPECT_EQ(decoded["id"_].get(), 2);
+}
@@ -0,0 +1,61 @@
+
+#include <named_tuple.h>
+#include <seqlock_tuple.h>
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using quote_t =
+    nvt::named_tuple<nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<int, decltype("size"_)>,
+                     nvt::named_value<std::uint64_t, decltype("ts"_)>,
+                     nvt::named_value<std::uint64_t, decltype("seq"_)>>;
+
+TEST(SeqlockTuple, PublishAndRead) {
+    nvt::seqlock_for_t<quote_t> q;
+    EXPECT_EQ(q.read<"px"_>(), 0.0);
+    EXPECT_EQ(q.version(), 0U);
+    q.publish(quote_t{("px"_, 10.5), ("size"_, 100), ("ts"_, 5ULL),
+                      ("seq"_, 1ULL)});
+    q.publish_fields(("size"_, 200), ("seq"_, std::uint64_t(2)));
+    q.publish(nvt::named_tuple{("ts"_, std::uint64_t(6))});
+    EXPECT_EQ(q.version(), 3U);
+
+    std::stringstream strm;
+    strm << q.snapshot();
+    EXPECT_EQ(strm.str(), "(px: 10.5, size: 200, ts: 6, seq: 2)");
+    EXPECT_EQ(q.read<"px"_>(), 10.5);
+    EXPECT_EQ(q.read<"size"_>(), 200);
+    EXPECT_EQ(q.read<"seq"_>(), 2U);
+}
+
+TEST(SeqlockTuple, ConsistentSnapshots) {
+    nvt::seqlock_for_t<quote_t> q;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                auto s = q.snapshot();
+                const auto seq = s["seq"_].get();
+                if (s["ts"_].get() != 2 * seq ||
+                    s["size"_].get() != int(seq % 1000) ||
+                    s["px"_].get() != double(seq))
+                    ++torn;
+            }
+        });
+    for (std::uint64_t i = 1; i <= 200000; ++i)
+        q.publish_fields(("px"_, double(i)), ("size"_, int(i % 1000)),
+                         ("ts"_, 2 * i), ("seq"_, i));
+    done = true;
+    for (auto& r : readers) r.join();
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(q.read<"seq"_>(), 200000U);
+}
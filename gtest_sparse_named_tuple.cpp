@@ -0,0 +1,81 @@
+
+#include <named_tuple.h>
+#include <sparse_named_tuple.h>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+using quote_t =
+    nvt::named_tuple<nvt::named_value<double, decltype("bid"_)>,
+                     nvt::named_value<double, decltype("ask"_)>,
+                     nvt::named_value<int, decltype("bid_qty"_)>,
+                     nvt::named_value<int, decltype("ask_qty"_)>,
+                     nvt::named_value<std::string, decltype("venue"_)>>;
+using update_t = nvt::sparse_for_t<quote_t>;
+
+// one 64 bit presence word instead of an optional flag and padding per field
+static_assert(sizeof(update_t) == sizeof(quote_t) + sizeof(std::uint64_t));
+
+TEST(SparseNamedTuple, PresenceBitmap) {
+    update_t u{("ask"_, 10.5), ("ask_qty"_, 300)};
+    EXPECT_TRUE(u.has<"ask"_>());
+    EXPECT_TRUE(u.has<"ask_qty"_>());
+    EXPECT_FALSE(u.has<"bid"_>());
+    EXPECT_EQ(u.count(), 2U);
+
+    u.set<"venue"_>("XNYS");
+    EXPECT_TRUE(u.has<"venue"_>());
+    u.reset<"ask_qty"_>();
+    EXPECT_FALSE(u.has<"ask_qty"_>());
+
+    EXPECT_EQ(u["bid"_].get(), 0.0);
+    EXPECT_EQ(u.get<decltype("bid_qty"_)>().get(), 0);
+    EXPECT_FALSE(u.has<"bid"_>());  // reads do not mark
+    EXPECT_FALSE(u.has<"bid_qty"_>());
+    static_assert(
+        std::is_const<std::remove_reference_t<decltype(u["bid"_])>>::value);
+
+    u.set<"bid"_>().get() = 9.75;  // marks, then writes
+    EXPECT_TRUE(u.has<"bid"_>());
+    EXPECT_EQ(u["bid"_].get(), 9.75);
+    u.reset<decltype("bid"_)>();
+    EXPECT_FALSE(u.has<"bid"_>());
+
+    std::stringstream strm;
+    strm << u;
+    EXPECT_EQ(strm.str(), "(ask: 10.5, venue: \"XNYS\")");
+
+    int n = 0;
+    u.foreach_present([&](const auto&) { ++n; });
+    EXPECT_EQ(n, 2);
+
+    u.clear();
+    EXPECT_TRUE(u.empty());
+}
+
+TEST(SparseNamedTuple, SparseMerge) {
+    quote_t book{("bid"_, 10.0), ("ask"_, 10.5), ("bid_qty"_, 100),
+                 ("ask_qty"_, 200), ("venue"_, "XNAS")};
+    update_t u{("bid_qty"_, 150)};
+    book << u;
+    std::stringstream strm;
+    strm << book;
+    EXPECT_EQ(strm.str(),
+              "(bid: 10, ask: 10.5, bid_qty: 150, ask_qty: 200, "
+              "venue: \"XNAS\")");
+
+    // accumulate updates, later ones win
+    update_t acc{("bid"_, 9.5), ("bid_qty"_, 1)};
+    acc << update_t{("bid_qty"_, 2), ("ask"_, 11.0)};
+    EXPECT_EQ(acc.count(), 3U);
+    EXPECT_EQ(acc["bid_qty"_].get(), 2);
+    EXPECT_EQ(acc["bid"_].get(), 9.5);
+
+    update_t full{book};
+    EXPECT_EQ(full.count(), 5U);
+}
@@ -0,0 +1,94 @@
+
+#include <named_tuple.h>
+#include <split_tuple.h>
+#include <array>
+#include <iostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace nvt = nvtuple_ns;
+
+NVT_FIELD_HOT("px"_)
+
+using order_t =
+    nvt::split_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::hot<nvt::named_value<int, decltype("qty"_)>>,
+                     nvt::named_value<std::string, decltype("note"_)>,
+                     nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<double, decltype("fee"_)>>;
+
+static_assert(order_t::is_hot<decltype("px"_)>());
+static_assert(order_t::is_hot<decltype("qty"_)>());
+static_assert(!order_t::is_hot<decltype("note"_)>());
+static_assert(order_t::hot_size == 16);
+static_assert(alignof(order_t) == order_t::cache_line);
+static_assert(sizeof(order_t) == order_t::cache_line);
+
+// all the fields hot: one full cache line, no cold block pointer
+using line_t = nvt::split_tuple<
+    nvt::hot<nvt::named_value<std::array<double, 7>, decltype("levels"_)>>,
+    nvt::hot<nvt::named_value<double, decltype("px"_)>>>;
+static_assert(!line_t::has_cold);
+static_assert(line_t::hot_size == line_t::cache_line);
+static_assert(sizeof(line_t) == line_t::cache_line);
+
+TEST(SplitTuple, NameAccessAcrossBlocks) {
+    order_t o{("px"_, 10.5), ("id"_, 7), ("note"_, std::string("manual"))};
+    o["qty"_] = 100;
+    EXPECT_EQ(o["px"_].get(), 10.5);
+    EXPECT_EQ(o["note"_].get(), "manual");
+    EXPECT_EQ(&o["px"_].get(), &o.hot_block()["px"_].get());
+    EXPECT_EQ(&o["id"_].get(), &o.cold_block()["id"_].get());
+    EXPECT_EQ(std::string(o.names()[3]), "px");
+    EXPECT_EQ(order_t::field_index("fee"), 4);
+
+    std::stringstream strm;
+    strm << o;
+    EXPECT_EQ(strm.str(),
+              "(id: 7, qty: 100, note: \"manual\", px: 10.5, fee: 0)");
+    std::stringstream tstrm;
+    tstrm << o.to_tuple();
+    EXPECT_EQ(tstrm.str(), strm.str());
+}
+
+TEST(SplitTuple, CopyMoveAndPool) {
+    std::vector<order_t> orders;
+    for (int i = 0; i < 1000; ++i)
+        orders.push_back(order_t{("id"_, i), ("px"_, double(i)),
+                                 ("note"_, std::string(40, 'x'))});
+    EXPECT_EQ(orders[999]["id"_].get(), 999);
+    EXPECT_EQ(orders[500]["note"_].get().size(), 40U);
+
+    order_t copy = orders[3];
+    copy["id"_] = -3;
+    EXPECT_EQ(orders[3]["id"_].get(), 3);
+
+    order_t moved = std::move(copy);
+    EXPECT_EQ(moved["id"_].get(), -3);
+    // the cold fields of a moved from tuple read as default values
+    EXPECT_EQ(std::as_const(copy)["note"_].get(), "");
+    order_t from_moved(copy);
+    EXPECT_EQ(from_moved["note"_].get(), "");
+    EXPECT_EQ(from_moved["fee"_].get(), 0.0);
+    moved = copy;
+    EXPECT_EQ(moved["note"_].get(), "");
+    copy["note"_] = std::string("again");  // allocates a cold block
+    EXPECT_EQ(std::as_const(copy)["note"_].get(), "again");
+    copy = orders[4];  // a moved from tuple can be assigned to
+    EXPECT_EQ(copy["id"_].get(), 4);
+
+    orders.clear();
+    order_t again;
+    again << nvt::named_tuple{("fee"_, 0.5), ("qty"_, 2)};
+    EXPECT_EQ(again["fee"_].get(), 0.5);
+    EXPECT_EQ(again["qty"_].get(), 2);
+
+    line_t line{("px"_, 2.5)};
+    line_t line_copy = line;
+    line_t line_moved = std::move(line_copy);
+    EXPECT_EQ(line_moved["px"_].get(), 2.5);
+    EXPECT_EQ(line_moved.to_tuple()["px"_].get(), 2.5);
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <exception_tuple.h>
+#include <named_table.h>
+#include <named_tuple.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// hash_index - open addressing index of the rows of a named_table by a
+// composite key of named fields:
+//
+//   nvt::hash_index<table_t, "sym"_, "venue"_> idx{table};
+//   std::size_t row = idx.find(nvt::named_tuple<...>{("sym"_, "IBM"),
+//                                                    ("venue"_, "XNYS")});
+//
+// Only the key fields are hashed, each with a hash picked by its value type
+// and combined in the order of the key names. A lookup key is anything with
+// the key fields by name: a narrow named_tuple of only the key fields, a
+// row, a view; string fields of any string type hash the same, so no key
+// string is built. Each slot holds the row number and 32 bits of its hash,
+// 8 bytes, probed linearly; the table rows are read only on a hash match.
+// The index keeps a pointer to the table; rows appended to the table are
+// indexed by update().
+
+namespace nvtuple_ns {
+
+namespace hash_detail {
+
+constexpr std::uint64_t mix(std::uint64_t h, std::uint64_t w) noexcept {
+    return std::rotl((h ^ w) * 0xff51afd7ed558ccdULL, 29);
+}
+
+constexpr std::uint64_t finish(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// hash of one key value, equal for equal values of different string types
+template<typename T>
+std::uint64_t value_hash(const T& v, std::uint64_t h) noexcept {
+    if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        if constexpr (std::is_signed<T>::value)
+            return mix(h, std::uint64_t(std::int64_t(v)));
+        else
+            return mix(h, std::uint64_t(v));
+    } else if constexpr (std::is_floating_point<T>::value) {
+        const double d = v == 0 ? 0.0 : double(v);  // -0.0 == 0.0
+        return mix(h, std::bit_cast<std::uint64_t>(d));
+    } else if constexpr (is_string_like_v<T>) {
+        const std::string_view s(v);
+        std::uint64_t w = s.size();
+        std::size_t i = 0;
+        for (; i + 8 <= s.size(); i += 8) {
+            std::uint64_t c;
+            std::memcpy(&c, s.data() + i, 8);
+            h = mix(h, c);
+        }
+        if (i < s.size()) {
+            std::uint64_t c = 0;
+            std::memcpy(&c, s.data() + i, s.size() - i);
+            w ^= c << 8;
+        }
+        return mix(h, w);
+    } else {
+        static_assert(is_string_like_v<T>,
+                      "no hash_index hash for this value type");
+    }
+}
+
+[[noreturn]] inline void too_large(std::size_t rows) {
+    throw NVT_EXCEPTION(("error"_, "hash_index table too large"),
+                        ("rows"_, rows));
+}
+
+template<typename T>
+decltype(auto) key_value(const T& v) noexcept {
+    if constexpr (requires { v.get(); })
+        return v.get();
+    else
+        return (v);
+}
+
+}  // namespace hash_detail
+
+template<typename Table, auto... K>
+class hash_index {
+    static_assert(sizeof...(K) > 0, "hash_index needs at least one key");
+
+   public:
+    using table_type = Table;
+    using row_type = std::uint32_t;
+
+    // the narrow named_tuple of the key fields, with the table value types
+    using key_type = named_tuple<named_value<
+        typename Table::template value_type_of<typename decltype(K)::type>,
+        typename decltype(K)::type>...>;
+
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    explicit hash_index(const Table& table) : _table(&table) { update(); }
+
+    // an index of a temporary table would dangle
+    explicit hash_index(const Table&&) = delete;
+
+    std::size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    std::size_t capacity() const noexcept { return _slots.size(); }
+
+    // index the rows appended to the table since the last update; a table
+    // that shrank, after clear() or resize(), is indexed again from row 0
+    void update() {
+        const std::size_t rows = _table->size();
+        if (rows >= empty_row) hash_detail::too_large(rows);
+        if (rows < _size) {
+            _slots.assign(_slots.size(), slot{});
+            _size = 0;
+        }
+        reserve(rows);
+        for (std::size_t r = _size; r < rows; ++r) insert(row_type(r));
+    }
+
+    // room for n rows without growing
+    void reserve(std::size_t n) {
+        std::size_t cap = std::max<std::size_t>(16, _slots.size());
+        while (n > cap / 4 * 3) cap *= 2;
+        if (cap != _slots.size()) rehash(cap);
+    }
+
+    // hash of the key fields of k, by name
+    template<typename Key>
+    static std::uint64_t hash(const Key& k) noexcept {
+        std::uint64_t h = 0x9e3779b97f4a7c15ULL;
+        (..., (h = hash_detail::value_hash(
+                   hash_detail::key_value(k[typename decltype(K)::type{}]),
+                   h)));
+        return hash_detail::finish(h);
+    }
+
+    // the first indexed row with the key fields of k, or npos
+    template<typename Key>
+    std::size_t find(const Key& k) const noexcept {
+        const std::uint64_t h = hash(k);
+        const auto tag = std::uint32_t(h >> 32);
+        for (std::size_t i = h & _mask;; i = (i + 1) & _mask) {
+            const slot& s = _slots[i];
+            if (s.row == empty_row) return npos;
+            if (s.tag == tag && equal(s.row, k)) return s.row;
+        }
+    }
+
+    template<typename Key>
+    bool contains(const Key& k) const noexcept {
+        return find(k) != npos;
+    }
+
+    // f(row) for all the indexed rows with the key fields of k
+    template<typename Key, typename F>
+    std::size_t for_each(const Key& k, F&& f) const {
+        const std::uint64_t h = hash(k);
+        const auto tag = std::uint32_t(h >> 32);
+        std::size_t n = 0;
+        for (std::size_t i = h & _mask;; i = (i + 1) & _mask) {
+            const slot& s = _slots[i];
+            if (s.row == empty_row) return n;
+            if (s.tag == tag && equal(s.row, k)) {
+                f(std::size_t(s.row));
+                ++n;
+            }
+        }
+    }
+
+   private:
+    static constexpr row_type empty_row = ~row_type(0);
+
+    struct slot {
+        row_type row{empty_row};
+        std::uint32_t tag{0};
+    };
+
+    template<typename Key>
+    bool equal(row_type r, const Key& k) const noexcept {
+        return (... && (_table->template column<typename decltype(K)::type>()
+                            [r] == hash_detail::key_value(
+                                       k[typename decltype(K)::type{}])));
+    }
+
+    std::uint64_t row_hash(row_type r) const noexcept {
+        std::uint64_t h = 0x9e3779b97f4a7c15ULL;
+        (..., (h = hash_detail::value_hash(
+                   _table->template column<typename decltype(K)::type>()[r],
+                   h)));
+        return hash_detail::finish(h);
+    }
+
+    void place(row_type r, std::uint64_t h) noexcept {
+        std::size_t i = h & _mask;
+        while (_slots[i].row != empty_row) i = (i + 1) & _mask;
+        _slots[i] = {r, std::uint32_t(h >> 32)};
+    }
+
+    void insert(row_type r) {
+        place(r, row_hash(r));
+        ++_size;
+    }
+
+    // the indexed rows are 0 .. size - 1, placed again in row order, so the
+    // first match of a key in its probe sequence is its first row
+    void rehash(std::size_t cap) {
+        _slots.assign(cap, slot{});
+        _mask = cap - 1;
+        for (std::size_t r = 0; r < _size; ++r)
+            place(row_type(r), row_hash(row_type(r)));
+    }
+
+    const Table* _table;
+    std::vector<slot> _slots;
+    std::size_t _mask{0};
+    std::size_t _size{0};
+};
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,105 @@
+// Benchmark: lookup of rows by a composite (sym, venue) key, an
+// std::unordered_map keyed by the concatenated strings compared to
+// hash_index over the table columns probed with a narrow named_tuple of
+// std::string_view fields. Row count from the command line, 1M-100M.
+
+#include <hash_index.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using quote_t =
+    nvt::named_tuple<nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<nvt::fixed_string<4>, decltype("venue"_)>,
+                     nvt::named_value<double, decltype("px"_)>>;
+using probe_t =
+    nvt::named_tuple<nvt::named_value<std::string_view, decltype("sym"_)>,
+                     nvt::named_value<std::string_view, decltype("venue"_)>>;
+
+static const char* const venues[]{"XNYS", "XNAS", "BATS", "ARCA",
+                                  "EDGX", "IEXG", "MEMX", "XCHI"};
+
+template<typename F>
+double ns_per(std::size_t count, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count()) /
+           double(count);
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const std::size_t lookups = 1000000;
+
+    nvt::table_for_t<quote_t> table;
+    table.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        quote_t q{("px"_, double(i))};
+        q["sym"_] = "SYMBOL" + std::to_string(i / 8);
+        q["venue"_].get() = venues[i % 8];
+        table.push_back(q);
+    }
+    std::mt19937_64 rng{42};
+    std::vector<std::size_t> probes(lookups);
+    for (auto& p : probes) p = rng() % n;
+
+    std::unordered_map<std::string, std::uint32_t> map;
+    const double map_build = ns_per(n, [&] {
+        map.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::string key = table["sym"_][i];
+            key += '|';
+            key += table["venue"_][i].view();
+            map.emplace(std::move(key), std::uint32_t(i));
+        }
+    });
+
+    std::size_t map_hits = 0;
+    const double map_find = ns_per(lookups, [&] {
+        std::string key;
+        for (std::size_t p : probes) {
+            const std::string_view sym = table["sym"_][p];
+            const std::string_view venue = table["venue"_][p].view();
+            key.assign(sym).append(1, '|').append(venue);
+            map_hits += map.find(key)->second == p;
+        }
+    });
+
+    using index_t = nvt::hash_index<nvt::table_for_t<quote_t>, "sym"_,
+                                    "venue"_>;
+    std::optional<index_t> index;
+    const double index_build = ns_per(n, [&] { index.emplace(table); });
+
+    std::size_t index_hits = 0;
+    const double index_find = ns_per(lookups, [&] {
+        for (std::size_t p : probes) {
+            const probe_t key{
+                ("sym"_, std::string_view(table["sym"_][p])),
+                ("venue"_, table["venue"_][p].view())};
+            index_hits += index->find(key) == p;
+        }
+    });
+
+    std::cout << n << " rows, " << lookups << " lookups\n"
+              << "unordered_map<string>: build " << map_build
+              << " ns/row, find " << map_find << " ns ("
+              << map_hits << " hits)\n"
+              << "hash_index:            build " << index_build
+              << " ns/row, find " << index_find << " ns (" << index_hits
+              << " hits)\n";
+    return 0;
+}
@@ -0,0 +1,491 @@
+#pragma once
+
+#include <exception_tuple.h>
+#include <named_tuple.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// mapped_table - a columnar file of named tuple rows, memory mapped and used
+// in place:
+//
+//   nvt::mapped_table_writer<TS...> w{"orders.nvt"};
+//   w.push_back(order);                     // streaming, any number of rows
+//   w.close();
+//
+//   auto t = nvt::mapped_table<TS...>::open("orders.nvt");
+//   std::span<const double> px = t["px"_];  // no parsing, no copy
+//
+// File layout, in the byte order of the writing host:
+//
+//   file_header     magic "NVTTABL1", version, byte order mark, field count,
+//                   row count
+//   column_header   per field: name, type code, column offset and size
+//   columns         each at a page aligned offset
+//
+// A fixed size column (arithmetic, enum, fixed_string, other trivially
+// copyable types) holds the row values as an array, mapped as a std::span.
+// A string column (std::string, std::pmr::string, std::string_view) holds
+// row count + 1 uint64 end offsets followed by the characters, read as
+// std::string_view. open() checks the byte order, the names and type codes
+// against the compiled schema, the column sizes against the row count and
+// the first and last string end offsets, and throws an exception_tuple on any
+// mismatch; a file of the other byte order is rejected, not converted. The
+// other end offsets are checked on access. Columns are mapped, not read: the
+// pages of a column are loaded on first access, or with prefetch<>().
+
+namespace nvtuple_ns {
+
+namespace mapped_detail {
+
+constexpr char magic[8]{'N', 'V', 'T', 'T', 'A', 'B', 'L', '1'};
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t byte_order = 0x01020304;  // 04 03 02 01 on x86
+constexpr std::size_t page_size = 4096;
+constexpr std::size_t name_capacity = 40;
+
+struct file_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t field_count;
+    std::uint64_t row_count;
+    std::uint32_t byte_order;
+    std::uint32_t reserved;
+};
+
+struct column_header {
+    char name[name_capacity];  // '\0' terminated
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t bytes;
+};
+
+static_assert(sizeof(file_header) == 32 && sizeof(column_header) == 64);
+
+template<typename VT>
+constexpr bool is_string_column =
+    is_std_string<VT>::value || std::is_same<VT, std::string_view>::value;
+
+template<typename VT>
+constexpr bool is_fixed_column =
+    std::is_trivially_copyable<VT>::value && !std::is_pointer<VT>::value &&
+    !std::is_same<VT, std::string_view>::value;
+
+// type code: kind character in the high byte, value size in the low bytes
+template<typename VT>
+constexpr std::uint32_t type_code() noexcept {
+    static_assert(is_fixed_column<VT> || is_string_column<VT>,
+                  "mapped_table columns are trivially copyable or strings");
+    char kind = 'r';  // raw trivially copyable bytes
+    if constexpr (is_string_column<VT>)
+        return std::uint32_t('s') << 24;
+    else if constexpr (std::is_same<VT, bool>::value)
+        kind = 'b';
+    else if constexpr (std::is_same<VT, char>::value)
+        kind = 'c';
+    else if constexpr (std::is_enum<VT>::value)
+        kind = 'e';
+    else if constexpr (std::is_floating_point<VT>::value)
+        kind = 'f';
+    else if constexpr (std::is_signed<VT>::value)
+        kind = 'i';
+    else if constexpr (std::is_unsigned<VT>::value)
+        kind = 'u';
+    else if constexpr (is_fixed_string<VT>::value)
+        kind = 'x';
+    return (std::uint32_t(kind) << 24) | std::uint32_t(sizeof(VT));
+}
+
+constexpr std::uint64_t page_align(std::uint64_t n) noexcept {
+    return (n + page_size - 1) & ~std::uint64_t(page_size - 1);
+}
+
+inline void write_bytes(std::FILE* f, const void* p, std::size_t n) {
+    if (n && std::fwrite(p, 1, n, f) != n)
+        throw NVT_EXCEPTION(("error"_, "mapped_table write failed"));
+}
+
+// not a template, so the func field of the exception stays short
+[[noreturn]] inline void fail(const char* error, const std::string& path) {
+    throw NVT_EXCEPTION(("error"_, error), ("path"_, path));
+}
+
+[[noreturn]] inline void fail(const char* error, const std::string& path,
+                              std::string_view field) {
+    throw NVT_EXCEPTION(("error"_, error), ("path"_, path), ("field"_, field));
+}
+
+[[noreturn]] inline void fail_row(const char* error, std::size_t row) {
+    throw NVT_EXCEPTION(("error"_, error), ("row"_, row));
+}
+
+}  // namespace mapped_detail
+
+// mapped_table_writer - appends rows to per column spill files, and writes
+// the table file on close(). Memory use does not depend on the row count.
+
+template<typename... TS>
+class mapped_table_writer {
+   public:
+    using tuple_type = named_tuple<TS...>;
+
+    explicit mapped_table_writer(std::string path) : _path(std::move(path)) {
+        static_assert(((std::string_view(TS::get_value_name()).size() <
+                        mapped_detail::name_capacity) &&
+                       ...),
+                      "mapped_table field names are at most 39 characters");
+        const std::array<bool, sizeof...(TS)> strings{
+            mapped_detail::is_string_column<typename TS::type>...};
+        for (std::size_t i = 0; i < sizeof...(TS); ++i) {
+            spill& s = _spills[i];
+            s.values.reset(std::tmpfile());
+            s.chars.reset(std::tmpfile());
+            if (!s.values || !s.chars)
+                mapped_detail::fail("mapped_table spill failed", _path);
+            // a string column starts with the end offset of row -1
+            if (strings[i])
+                mapped_detail::write_bytes(s.values.get(), &s.end,
+                                           sizeof(s.end));
+        }
+    }
+
+    mapped_table_writer(const mapped_table_writer&) = delete;
+    mapped_table_writer& operator=(const mapped_table_writer&) = delete;
+
+    ~mapped_table_writer() {
+        if (!_closed) {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+
+    // append a row from a named tuple with the same field names, in any order
+    template<typename... ST>
+    void push_back(const named_tuple<ST...>& t) {
+        static_assert(sizeof...(ST) == sizeof...(TS),
+                      "push_back requires a named tuple with matching names");
+        append_fields(t, std::index_sequence_for<TS...>{});
+        ++_rows;
+    }
+
+    std::size_t size() const noexcept { return _rows; }
+
+    // write the table file, through a temporary file renamed over path
+    void close() {
+        if (_closed) return;
+        _closed = true;
+        using namespace mapped_detail;
+        const std::string tmp = _path + ".tmp";
+        std::unique_ptr<std::FILE, file_closer> out{
+            std::fopen(tmp.c_str(), "wb")};
+        if (!out) mapped_detail::fail("mapped_table create failed", tmp);
+
+        file_header fh{};
+        std::memcpy(fh.magic, magic, sizeof(magic));
+        fh.version = version;
+        fh.byte_order = byte_order;
+        fh.field_count = sizeof...(TS);
+        fh.row_count = _rows;
+
+        std::array<column_header, sizeof...(TS)> ch{};
+        const std::array<const char*, sizeof...(TS)> nms{
+            TS::get_value_name()...};
+        const std::array<std::uint32_t, sizeof...(TS)> types{
+            type_code<typename TS::type>()...};
+        std::uint64_t at =
+            page_align(sizeof(file_header) + sizeof(ch));
+        for (std::size_t i = 0; i < sizeof...(TS); ++i) {
+            std::strncpy(ch[i].name, nms[i], name_capacity - 1);
+            ch[i].type = types[i];
+            ch[i].offset = at;
+            ch[i].bytes = spill_size(_spills[i].values.get()) +
+                          spill_size(_spills[i].chars.get());
+            at = page_align(at + ch[i].bytes);
+        }
+        write_bytes(out.get(), &fh, sizeof(fh));
+        write_bytes(out.get(), ch.data(), sizeof(ch));
+        std::uint64_t pos = sizeof(fh) + sizeof(ch);
+        for (std::size_t i = 0; i < sizeof...(TS); ++i) {
+            pad(out.get(), ch[i].offset - pos);
+            copy(out.get(), _spills[i].values.get());
+            copy(out.get(), _spills[i].chars.get());
+            pos = ch[i].offset + ch[i].bytes;
+        }
+        pad(out.get(), at - pos);
+        if (std::fflush(out.get()) != 0 ||
+            std::rename(tmp.c_str(), _path.c_str()) != 0)
+            mapped_detail::fail("mapped_table write failed", _path);
+    }
+
+   private:
+    struct file_closer {
+        void operator()(std::FILE* f) const noexcept { std::fclose(f); }
+    };
+    struct spill {
+        std::unique_ptr<std::FILE, file_closer> values;  // values, or ends
+        std::unique_ptr<std::FILE, file_closer> chars;   // string columns
+        std::uint64_t end{0};
+    };
+
+    template<typename Tuple, std::size_t... I>
+    void append_fields(const Tuple& t, std::index_sequence<I...>) {
+        (..., append(_spills[I],
+                     t[typename std::tuple_element_t<
+                         I, std::tuple<TS...>>::namedtype{}]
+                         .get()));
+    }
+
+    template<typename VT>
+    void append(spill& s, const VT& v) {
+        if constexpr (mapped_detail::is_string_column<VT>) {
+            const std::string_view sv(v);
+            mapped_detail::write_bytes(s.chars.get(), sv.data(), sv.size());
+            s.end += sv.size();
+            mapped_detail::write_bytes(s.values.get(), &s.end, sizeof(s.end));
+        } else {
+            mapped_detail::write_bytes(s.values.get(), &v, sizeof(VT));
+        }
+    }
+
+    std::uint64_t spill_size(std::FILE* f) const {
+        const long n = std::fflush(f) == 0 ? std::ftell(f) : -1L;
+        if (n < 0) mapped_detail::fail("mapped_table spill failed", _path);
+        return std::uint64_t(n);
+    }
+
+    static void pad(std::FILE* out, std::uint64_t n) {
+        static const char zeros[mapped_detail::page_size]{};
+        mapped_detail::write_bytes(out, zeros, std::size_t(n));
+    }
+
+    static void copy(std::FILE* out, std::FILE* in) {
+        char buf[1 << 16];
+        std::rewind(in);
+        for (std::size_t n; (n = std::fread(buf, 1, sizeof(buf), in)) > 0;)
+            mapped_detail::write_bytes(out, buf, n);
+    }
+
+    std::string _path;
+    std::array<spill, sizeof...(TS)> _spills;
+    std::uint64_t _rows{0};
+    bool _closed{false};
+};
+
+// string_column - the std::string_view values of a mapped string column
+
+class string_column {
+   public:
+    string_column(const std::uint64_t* ends, const char* chars,
+                  std::size_t size) noexcept
+        : _ends(ends), _chars(chars), _size(size) {}
+
+    std::size_t size() const noexcept { return _size; }
+
+    // i < size(); the end offsets of row i are checked here, not all of
+    // them by open(), so that open() does not read the whole column. The
+    // last end offset, checked by open(), is the size of the characters.
+    std::string_view operator[](std::size_t i) const {
+        const std::uint64_t begin = _ends[i];
+        const std::uint64_t end = _ends[i + 1];
+        if (begin > end || end > _ends[_size])
+            mapped_detail::fail_row("string column offsets corrupt", i);
+        return {_chars + begin, std::size_t(end - begin)};
+    }
+
+   private:
+    const std::uint64_t* _ends;
+    const char* _chars;
+    std::size_t _size;
+};
+
+// mapped_table - read only, memory mapped table file of the schema TS...
+
+template<typename... TS>
+class mapped_table {
+   public:
+    using tuple_type = named_tuple<TS...>;
+
+    // map the file and check its schema, throws exception_tuple
+    static mapped_table open(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) mapped_detail::fail("mapped_table open failed", path);
+        struct stat st;
+        const bool stat_ok = ::fstat(fd, &st) == 0;
+        void* p = stat_ok && st.st_size > 0
+                      ? ::mmap(nullptr, std::size_t(st.st_size), PROT_READ,
+                               MAP_SHARED, fd, 0)
+                      : MAP_FAILED;
+        ::close(fd);
+        if (p == MAP_FAILED)
+            mapped_detail::fail("mapped_table mmap failed", path);
+        mapped_table t{static_cast<const std::byte*>(p),
+                       std::size_t(st.st_size)};
+        t.check(path);
+        return t;
+    }
+
+    mapped_table(mapped_table&& o) noexcept
+        : _data(std::exchange(o._data, nullptr)),
+          _size(std::exchange(o._size, 0)) {}
+
+    mapped_table& operator=(mapped_table&& o) noexcept {
+        std::swap(_data, o._data);
+        std::swap(_size, o._size);
+        return *this;
+    }
+
+    ~mapped_table() {
+        if (_data) ::munmap(const_cast<std::byte*>(_data), _size);
+    }
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            TS::get_value_name()...};
+    }
+
+    std::size_t size() const noexcept {
+        return std::size_t(header().row_count);
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    // the mapped column: a std::span of the values, or a string_column
+    template<typename T>
+    auto column() const noexcept {
+        constexpr auto i = std::size_t(get_index<T>());
+        using VT = typename std::tuple_element_t<i, std::tuple<TS...>>::type;
+        const std::byte* p = _data + columns()[i].offset;
+        if constexpr (mapped_detail::is_string_column<VT>) {
+            const auto* ends = reinterpret_cast<const std::uint64_t*>(p);
+            return string_column{
+                ends,
+                reinterpret_cast<const char*>(ends + size() + 1), size()};
+        } else {
+            return std::span<const VT>{reinterpret_cast<const VT*>(p),
+                                       size()};
+        }
+    }
+
+    template<typename T>
+    auto operator[](T) const noexcept {
+        return column<T>();
+    }
+
+    // copy of row i as a named_tuple of the schema
+    tuple_type to_tuple(std::size_t i) const {
+        tuple_type t;
+        (..., (t[typename TS::namedtype{}] =
+                   typename TS::type(column<typename TS::namedtype>()[i])));
+        return t;
+    }
+
+    // ask the kernel to read the pages of a column ahead of the scan
+    template<typename T>
+    void prefetch() const noexcept {
+        const auto& c = columns()[std::size_t(get_index<T>())];
+        ::madvise(const_cast<std::byte*>(_data + c.offset),
+                  std::size_t(c.bytes), MADV_WILLNEED);
+    }
+
+   private:
+    mapped_table(const std::byte* data, std::size_t size) noexcept
+        : _data(data), _size(size) {}
+
+    const mapped_detail::file_header& header() const noexcept {
+        return *reinterpret_cast<const mapped_detail::file_header*>(_data);
+    }
+
+    const mapped_detail::column_header* columns() const noexcept {
+        return reinterpret_cast<const mapped_detail::column_header*>(
+            _data + sizeof(mapped_detail::file_header));
+    }
+
+    void check(const std::string& path) const {
+        using namespace mapped_detail;
+        if (_size < sizeof(file_header) + sizeof...(TS) * sizeof(column_header))
+            fail("mapped_table file too short", path);
+        const file_header& h = header();
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0)
+            fail("not a mapped_table file", path);
+        if (h.version != version)
+            fail("unsupported mapped_table version", path);
+        if (h.byte_order != byte_order)
+            fail("mapped_table byte order mismatch", path);
+        if (h.field_count != sizeof...(TS)) fail("field count mismatch", path);
+        const std::array<const char*, sizeof...(TS)> nms{
+            TS::get_value_name()...};
+        const std::array<std::uint32_t, sizeof...(TS)> types{
+            type_code<typename TS::type>()...};
+        const std::array<bool, sizeof...(TS)> strings{
+            is_string_column<typename TS::type>...};
+        const std::array<std::size_t, sizeof...(TS)> sizes{
+            sizeof(typename TS::type)...};
+        const std::uint64_t rows = h.row_count;
+        for (std::size_t i = 0; i < sizeof...(TS); ++i) {
+            const column_header& c = columns()[i];
+            if (std::string_view(c.name, strnlen(c.name, name_capacity)) !=
+                nms[i])
+                fail("field name mismatch", path, nms[i]);
+            if (c.type != types[i])
+                fail("field type mismatch", path, nms[i]);
+            if (c.offset % page_size != 0 || c.offset > _size ||
+                c.bytes > _size - c.offset)
+                fail("column out of the file", path, nms[i]);
+            // rows is bounded by the column size before any multiplication
+            if (strings[i]) {
+                if (rows >= c.bytes / sizeof(std::uint64_t))
+                    fail("string column size mismatch", path, nms[i]);
+                const auto* ends =
+                    reinterpret_cast<const std::uint64_t*>(_data + c.offset);
+                if (ends[rows] != c.bytes - (rows + 1) * sizeof(std::uint64_t))
+                    fail("string column size mismatch", path, nms[i]);
+                if (ends[0] != 0)
+                    fail("string column offsets corrupt", path, nms[i]);
+            } else if (rows > c.bytes / sizes[i] ||
+                       c.bytes != rows * sizes[i]) {
+                fail("column size mismatch", path, nms[i]);
+            }
+        }
+    }
+
+    const std::byte* _data;
+    std::size_t _size;
+};
+
+// mapped_table_for<named_tuple<TS...>>::type is mapped_table<TS...>
+
+template<typename T>
+struct mapped_table_for;
+
+template<typename... TS>
+struct mapped_table_for<named_tuple<TS...>> {
+    using type = mapped_table<TS...>;
+    using writer_type = mapped_table_writer<TS...>;
+};
+
+template<typename T>
+using mapped_table_for_t = typename mapped_table_for<T>::type;
+
+}  // namespace nvtuple_ns
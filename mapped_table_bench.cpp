@@ -0,0 +1,92 @@
+// Benchmark: loading a stored record set at process start, reading and
+// deserializing a named_serialize stream into a named_table compared to
+// opening a mapped_table file and scanning a column in place.
+
+#include <mapped_table.h>
+#include <named_serialize.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<nvt::fixed_string<8>, decltype("sym"_)>,
+                     nvt::named_value<std::string, decltype("note"_)>>;
+
+static order_t make_order(std::size_t i) {
+    order_t o{("id"_, int(i)), ("px"_, double(i % 1000) * 0.25),
+              ("qty"_, int(i % 100))};
+    o["sym"_] = "SYM";
+    o["note"_] = "note";
+    return o;
+}
+
+template<typename F>
+double elapsed_ms(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    const std::string stream_path = "mapped_table_bench.bin";
+    const std::string table_path = "mapped_table_bench.nvt";
+
+    {
+        std::vector<std::byte> buf;
+        nvt::vector_sink sink{buf};
+        nvt::mapped_table_for<order_t>::writer_type w{table_path};
+        for (std::size_t i = 0; i < n; ++i) {
+            const order_t o = make_order(i);
+            nvt::serialize(o, sink);
+            w.push_back(o);
+        }
+        std::ofstream{stream_path, std::ios::binary}.write(
+            reinterpret_cast<const char*>(buf.data()),
+            std::streamsize(buf.size()));
+    }
+
+    double parsed_sum = 0;
+    const double parse_ms = elapsed_ms([&] {
+        std::ifstream in{stream_path, std::ios::binary};
+        std::vector<std::byte> buf(
+            std::size_t(in.seekg(0, std::ios::end).tellg()));
+        in.seekg(0).read(reinterpret_cast<char*>(buf.data()),
+                         std::streamsize(buf.size()));
+        nvt::buffer_source src{buf};
+        nvt::table_for_t<order_t> table;
+        table.reserve(n);
+        order_t o;
+        while (nvt::deserialize(src, o)) table.push_back(o);
+        for (double px : table["px"_]) parsed_sum += px;
+    });
+
+    double mapped_sum = 0;
+    const double mapped_ms = elapsed_ms([&] {
+        auto table = nvt::mapped_table_for_t<order_t>::open(table_path);
+        for (double px : table["px"_]) mapped_sum += px;
+    });
+
+    std::cout << n << " rows\n"
+              << "deserialize into named_table + scan: " << parse_ms
+              << " ms\n"
+              << "mapped_table open + scan:            " << mapped_ms
+              << " ms\n";
+    std::remove(stream_path.c_str());
+    std::remove(table_path.c_str());
+    return parsed_sum == mapped_sum ? 0 : 1;
+}
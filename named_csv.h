@@ -0,0 +1,506 @@
+#pragma once
+
+#include <exception_tuple.h>
+#include <named_table.h>
+#include <named_tuple.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// CSV text for named tuples and named tables:
+//
+//   std::string out;
+//   nvt::csv_header<order_t>(out);         // "id,sym,px\n", compile time
+//   nvt::to_csv(order, out);               // "7,AAPL,10.5\n"
+//
+//   nvt::read_csv<order_t>(text, [](const order_t& o) { ... });
+//   auto table = nvt::read_csv_table<order_t>(text);   // all cores
+//
+// The first line of the text is the header. Its column names are matched
+// once to the tuple fields with the compile time perfect hash name_index<>;
+// columns that are not fields are skipped, fields without a column keep
+// their default value. Numbers are written with std::to_chars and parsed
+// with std::from_chars, so floating point NaN and infinity round trip as
+// nan and inf; an empty cell is the default value of the field type. Cells
+// may be quoted, with "" for a quote; CRLF line ends are accepted.
+//
+// read_csv_parallel() and read_csv_table() split the rows across threads at
+// newline boundaries, so quoted cells must not contain newlines there. The
+// parallel callback is called concurrently from the worker threads, each
+// with the rows of its part of the text in order; read_csv_table() appends
+// the parts in the text order. Errors throw an exception_tuple with the
+// error text and the offset in the text.
+
+namespace nvtuple_ns {
+
+namespace csv_detail {
+
+[[noreturn]] inline void fail(const char* error, std::size_t offset) {
+    throw NVT_EXCEPTION(("error"_, error), ("offset"_, offset));
+}
+
+// "name,name,...\n" built at compile time from the named_type characters
+
+template<typename... TS>
+struct header_text {
+    static constexpr std::size_t size =
+        (std::size_t(0) + ... + (TS::namedtype::_name_sv.size() + 1));
+    static constexpr std::array<char, size> text = [] {
+        std::array<char, size> a{};
+        std::size_t n = 0;
+        for (std::string_view name : {TS::namedtype::_name_sv...}) {
+            for (char c : name) a[n++] = c;
+            a[n++] = ',';
+        }
+        a[size - 1] = '\n';
+        return a;
+    }();
+};
+
+template<typename T>
+struct header_text_for;
+
+template<typename... TS>
+struct header_text_for<named_tuple<TS...>> {
+    using type = header_text<TS...>;
+};
+
+inline void write_string(std::string& out, std::string_view s) {
+    if (s.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(s);
+        return;
+    }
+    out += '"';
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+template<typename T>
+void write_value(std::string& out, const T& v) {
+    static_assert(!is_named_tuple<T>::value,
+                  "CSV has no nested named tuple fields");
+    if constexpr (std::is_same<T, bool>::value) {
+        out += v ? "true" : "false";
+    } else if constexpr (std::is_same<T, char>::value) {
+        write_string(out, std::string_view(&v, 1));
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        char buf[64];
+        auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, r.ptr);
+    } else if constexpr (is_string_like_v<T>) {
+        write_string(out, v);
+    } else {
+        static_assert(is_string_like_v<T>,
+                      "no CSV encoding for this value type");
+    }
+}
+
+// one cell of a line: its text without the quotes, escaped when it holds ""
+struct cell {
+    std::string_view text;
+    bool escaped;
+    std::size_t offset;
+};
+
+inline std::string_view unescape(const cell& c, std::string& scratch) {
+    if (!c.escaped) return c.text;
+    scratch.clear();
+    for (std::size_t i = 0; i < c.text.size(); ++i) {
+        scratch += c.text[i];
+        if (c.text[i] == '"') ++i;  // "" is one quote
+    }
+    return scratch;
+}
+
+template<typename T>
+void read_value(const cell& c, T& v, std::string& scratch) {
+    static_assert(!is_named_tuple<T>::value,
+                  "CSV has no nested named tuple fields");
+    const std::string_view s = c.text;
+    if constexpr (std::is_same<T, bool>::value) {
+        if (s == "true" || s == "1")
+            v = true;
+        else if (s == "false" || s == "0" || s.empty())
+            v = false;
+        else
+            fail("expected true or false", c.offset);
+    } else if constexpr (std::is_same<T, char>::value) {
+        const auto u = unescape(c, scratch);
+        if (u.size() > 1) fail("expected one character", c.offset);
+        v = u.empty() ? char{} : u[0];
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        if (s.empty()) {
+            v = T{};
+            return;
+        }
+        std::from_chars_result r;
+        if constexpr (std::is_floating_point<T>::value)
+            r = std::from_chars(s.data(), s.data() + s.size(), v,
+                                std::chars_format::general);
+        else
+            r = std::from_chars(s.data(), s.data() + s.size(), v);
+        if (r.ec != std::errc{} || r.ptr != s.data() + s.size())
+            fail("invalid number", c.offset);
+    } else if constexpr (is_std_string<T>::value) {
+        const auto u = unescape(c, scratch);
+        v.assign(u.data(), u.size());
+    } else if constexpr (std::is_same<T, std::string_view>::value) {
+        // a view of the input text, valid as long as the text
+        if (c.escaped)
+            fail("quoted cell with \"\" read into a string_view", c.offset);
+        v = s;
+    } else if constexpr (is_fixed_string<T>::value) {
+        if (!v.assign(unescape(c, scratch))) fail("string too long", c.offset);
+    } else {
+        static_assert(is_std_string<T>::value,
+                      "no CSV decoding for this value type");
+    }
+}
+
+template<typename Tuple, std::size_t I>
+void read_field(const cell& c, Tuple& t, std::string& scratch) {
+    read_value(c, std::get<I>(t).get(), scratch);
+}
+
+template<typename... TS, std::size_t... I>
+constexpr auto field_readers(std::index_sequence<I...>) noexcept {
+    return std::array<void (*)(const cell&, named_tuple<TS...>&,
+                               std::string&),
+                      sizeof...(TS)>{&read_field<named_tuple<TS...>, I>...};
+}
+
+// the next cell at p, p is left on the ',', '\n' or end after the cell.
+// false when the text ends inside a quoted cell.
+inline bool next_cell(const char* begin, const char*& p, const char* end,
+                      cell& c) {
+    c.offset = std::size_t(p - begin);
+    c.escaped = false;
+    if (p != end && *p == '"') {
+        const char* start = ++p;
+        for (;;) {
+            p = static_cast<const char*>(
+                std::memchr(p, '"', std::size_t(end - p)));
+            if (!p) return false;
+            if (p + 1 != end && p[1] == '"') {
+                c.escaped = true;
+                p += 2;
+                continue;
+            }
+            c.text = {start, std::size_t(p++ - start)};
+            if (p != end && *p == '\r') ++p;
+            if (p != end && *p != ',' && *p != '\n')
+                fail("text after a quoted cell", std::size_t(p - begin));
+            return true;
+        }
+    }
+    const char* start = p;
+    while (p != end && *p != ',' && *p != '\n') ++p;
+    const char* last = p;
+    if (last != start && last[-1] == '\r' && (p == end || *p == '\n')) --last;
+    c.text = {start, std::size_t(last - start)};
+    return true;
+}
+
+// [begin, end) cut into about n parts that end after a '\n'
+inline std::vector<std::string_view> split_lines(std::string_view text,
+                                                 std::size_t n) {
+    std::vector<std::string_view> parts;
+    std::size_t at = 0;
+    for (std::size_t i = 1; i <= n && at < text.size(); ++i) {
+        std::size_t cut = i == n ? text.size() : text.size() * i / n;
+        if (cut < at) cut = at;
+        cut = std::min(text.find('\n', cut), text.size() - 1) + 1;
+        if (i == n) cut = text.size();
+        parts.push_back(text.substr(at, cut - at));
+        at = cut;
+    }
+    return parts;
+}
+
+// worker count for text of size bytes, at least 64 KiB of text per worker
+inline std::size_t workers(std::size_t size, unsigned threads) noexcept {
+    const std::size_t n =
+        threads ? threads : std::thread::hardware_concurrency();
+    return std::clamp<std::size_t>(size >> 16, 1,
+                                   std::max<std::size_t>(n, 1));
+}
+
+}  // namespace csv_detail
+
+// csv_reader - the header mapping and the row parser of one reader thread
+
+template<typename... TS>
+class csv_reader {
+   public:
+    using tuple_type = named_tuple<TS...>;
+
+    // map the columns of the header line, the text up to the first '\n'
+    explicit csv_reader(std::string_view header) {
+        if (!header.empty() && header.back() == '\n') header.remove_suffix(1);
+        const char* p = header.data();
+        const char* end = p + header.size();
+        std::array<bool, sizeof...(TS)> seen{};
+        csv_detail::cell c;
+        for (;;) {
+            if (!csv_detail::next_cell(header.data(), p, end, c))
+                csv_detail::fail("unterminated quoted cell", c.offset);
+            const int i = tuple_type::field_index(c.text);
+            if (i >= 0) {
+                if (seen[std::size_t(i)])
+                    csv_detail::fail("duplicate header column", c.offset);
+                seen[std::size_t(i)] = true;
+            }
+            _fields.push_back(i);
+            if (p == end) break;
+            ++p;
+        }
+    }
+
+    // the column count of the header
+    std::size_t columns() const noexcept { return _fields.size(); }
+
+    // f(const tuple_type&) for every complete line of text, a line without
+    // its '\n' when last. Returns the size of the parsed text; the rest,
+    // when not last, is the start of a line continued in the next chunk.
+    // offset is the offset of text in the input, for the error offsets.
+    template<typename F>
+    std::size_t parse(std::string_view text, F&& f, bool last = true,
+                      std::size_t offset = 0) {
+        static constexpr auto readers = csv_detail::field_readers<TS...>(
+            std::index_sequence_for<TS...>{});
+        const char* begin = text.data() - offset;
+        const char* p = text.data();
+        const char* end = p + text.size();
+        const char* line = p;
+        csv_detail::cell c;
+        while (p != end) {
+            if (!last && !std::memchr(p, '\n', std::size_t(end - p)))
+                return std::size_t(line - text.data());
+            if (*p == '\n' || (*p == '\r' && p + 1 != end && p[1] == '\n')) {
+                p += *p == '\r' ? 2 : 1;  // blank line
+                line = p;
+                continue;
+            }
+            std::size_t col = 0;
+            for (;; ++col) {
+                if (!csv_detail::next_cell(begin, p, end, c)) {
+                    if (!last) return std::size_t(line - text.data());
+                    csv_detail::fail("unterminated quoted cell", c.offset);
+                }
+                if (col < _fields.size() && _fields[col] >= 0)
+                    readers[std::size_t(_fields[col])](c, _row, _scratch);
+                if (p == end || *p == '\n') break;
+                ++p;
+            }
+            if (p == end && !last) return std::size_t(line - text.data());
+            if (col + 1 != _fields.size())
+                csv_detail::fail("column count mismatch",
+                                 std::size_t(line - begin));
+            f(std::as_const(_row));
+            if (p != end) ++p;
+            line = p;
+        }
+        return text.size();
+    }
+
+   private:
+    std::vector<int> _fields;  // field index of each column, -1 to skip
+    tuple_type _row{};
+    std::string _scratch;
+};
+
+template<typename T>
+struct csv_reader_for;
+
+template<typename... TS>
+struct csv_reader_for<named_tuple<TS...>> {
+    using type = csv_reader<TS...>;
+};
+
+template<typename T>
+using csv_reader_for_t = typename csv_reader_for<T>::type;
+
+// csv_header - append the header line of the fields of Tuple to out
+
+template<typename Tuple>
+std::string& csv_header(std::string& out) {
+    using text = typename csv_detail::header_text_for<Tuple>::type;
+    return out.append(text::text.data(), text::size);
+}
+
+// to_csv - append the CSV line of t, or the header and lines of a table
+
+template<typename... TS>
+std::string& to_csv(const named_tuple<TS...>& t, std::string& out) {
+    const char* sep = "";
+    (..., (out += sep, sep = ",",
+           csv_detail::write_value(out, t[typename TS::namedtype{}].get())));
+    out += '\n';
+    return out;
+}
+
+template<typename... TS>
+std::string& to_csv(const named_table<TS...>& table, std::string& out) {
+    csv_header<named_tuple<TS...>>(out);
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        const char* sep = "";
+        (..., (out += sep, sep = ",",
+               csv_detail::write_value(
+                   out, table.template column<typename TS::namedtype>()[i])));
+        out += '\n';
+    }
+    return out;
+}
+
+// read_csv - f(const Tuple&) for every row of the text, or of the stream
+// read in chunks. Returns the row count.
+
+template<typename Tuple, typename F>
+std::size_t read_csv(std::string_view text, F&& f) {
+    const std::size_t eol = std::min(text.find('\n'), text.size());
+    csv_reader_for_t<Tuple> reader{text.substr(0, eol)};
+    std::size_t rows = 0;
+    const std::size_t body = std::min(eol + 1, text.size());
+    reader.parse(
+        text.substr(body),
+        [&](const Tuple& t) {
+            f(t);
+            ++rows;
+        },
+        true, body);
+    return rows;
+}
+
+template<typename Tuple, typename F>
+std::size_t read_csv(std::istream& in, F&& f,
+                     std::size_t chunk_size = std::size_t(1) << 20) {
+    std::string buf;
+    std::getline(in, buf);
+    csv_reader_for_t<Tuple> reader{buf};
+    std::size_t rows = 0;
+    std::size_t offset = buf.size() + 1;
+    const auto count = [&](const Tuple& t) {
+        f(t);
+        ++rows;
+    };
+    buf.clear();
+    for (bool last = false; !last;) {
+        const std::size_t kept = buf.size();
+        buf.resize(kept + chunk_size);
+        in.read(buf.data() + kept, std::streamsize(chunk_size));
+        buf.resize(kept + std::size_t(in.gcount()));
+        last = !in;
+        const std::size_t used = reader.parse(buf, count, last, offset);
+        buf.erase(0, used);
+        offset += used;
+    }
+    return rows;
+}
+
+// read_csv_parallel - f(const Tuple&) for every row, called concurrently
+// from up to threads worker threads (0: the hardware concurrency).
+
+template<typename Tuple, typename F>
+std::size_t read_csv_parallel(std::string_view text, F&& f,
+                              unsigned threads = 0) {
+    const std::size_t eol = std::min(text.find('\n'), text.size());
+    const csv_reader_for_t<Tuple> reader{text.substr(0, eol)};
+    const std::size_t body = std::min(eol + 1, text.size());
+    const auto parts = csv_detail::split_lines(
+        text.substr(body), csv_detail::workers(text.size() - body, threads));
+
+    std::vector<std::size_t> rows(parts.size());
+    std::vector<std::exception_ptr> errors(parts.size());
+    const auto work = [&](std::size_t i) {
+        try {
+            auto r = reader;
+            r.parse(
+                parts[i],
+                [&](const Tuple& t) {
+                    f(t);
+                    ++rows[i];
+                },
+                true, std::size_t(parts[i].data() - text.data()));
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < parts.size(); ++i) pool.emplace_back(work, i);
+    if (!parts.empty()) work(0);
+    for (auto& t : pool) t.join();
+    for (auto& e : errors)
+        if (e) std::rethrow_exception(e);
+    std::size_t total = 0;
+    for (std::size_t n : rows) total += n;
+    return total;
+}
+
+// read_csv_table - the rows of the text as a named_table, parsed by up to
+// threads worker threads, straight into per thread columns
+
+template<typename Tuple>
+table_for_t<Tuple> read_csv_table(std::string_view text,
+                                  unsigned threads = 0) {
+    const std::size_t eol = std::min(text.find('\n'), text.size());
+    const csv_reader_for_t<Tuple> reader{text.substr(0, eol)};
+    const std::size_t body = std::min(eol + 1, text.size());
+    const auto parts = csv_detail::split_lines(
+        text.substr(body), csv_detail::workers(text.size() - body, threads));
+
+    std::vector<table_for_t<Tuple>> tables(parts.size());
+    std::vector<std::exception_ptr> errors(parts.size());
+    const auto work = [&](std::size_t i) {
+        try {
+            auto r = reader;
+            // about the row count of the part, from its first line
+            const std::size_t line = parts[i].find('\n') + 1;
+            if (line) tables[i].reserve(parts[i].size() / line);
+            r.parse(
+                parts[i], [&](const Tuple& t) { tables[i].push_back(t); },
+                true, std::size_t(parts[i].data() - text.data()));
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < parts.size(); ++i) pool.emplace_back(work, i);
+    if (!parts.empty()) work(0);
+    for (auto& t : pool) t.join();
+    for (auto& e : errors)
+        if (e) std::rethrow_exception(e);
+
+    if (tables.empty()) return {};
+    std::size_t total = 0;
+    for (const auto& t : tables) total += t.size();
+    auto& out = tables.front();
+    out.reserve(total);
+    for (std::size_t i = 1; i < tables.size(); ++i) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (..., std::get<I>(out.columns())
+                      .insert(std::get<I>(out.columns()).end(),
+                              std::make_move_iterator(
+                                  std::get<I>(tables[i].columns()).begin()),
+                              std::make_move_iterator(
+                                  std::get<I>(tables[i].columns()).end())));
+        }(std::make_index_sequence<table_for_t<Tuple>::column_count()>{});
+    }
+    return std::move(out);
+}
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,85 @@
+// Benchmark: CSV ingest of order rows, a std::getline / std::stod loop
+// compared to read_csv() into a callback and read_csv_table() into columns
+// with one and with all hardware threads.
+
+#include <named_csv.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<nvt::fixed_string<8>, decltype("sym"_)>,
+                     nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<std::string, decltype("account"_)>>;
+
+template<typename F>
+void run(const char* label, std::size_t bytes, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    const double sum = f();
+    const double s = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    std::cout << label << ": " << double(bytes) / s / 1e6 << " MB/s (" << sum
+              << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+
+    std::string text;
+    nvt::csv_header<order_t>(text);
+    for (std::size_t i = 0; i < n; ++i) {
+        order_t o{("id"_, int(i)), ("px"_, double(i % 10000) * 0.01),
+                  ("qty"_, int(i % 500))};
+        o["sym"_].get() = "SYM";
+        o["account"_] = "ACCOUNT-1";
+        nvt::to_csv(o, text);
+    }
+
+    run("getline + stod           ", text.size(), [&] {
+        std::istringstream in{text};
+        std::string line, cell;
+        double sum = 0;
+        std::getline(in, line);
+        while (std::getline(in, line)) {
+            std::istringstream cells{line};
+            for (int c = 0; std::getline(cells, cell, ','); ++c)
+                if (c == 2) sum += std::stod(cell);
+        }
+        return sum;
+    });
+
+    run("read_csv, callback       ", text.size(), [&] {
+        double sum = 0;
+        nvt::read_csv<order_t>(
+            text, [&](const order_t& o) { sum += o["px"_].get(); });
+        return sum;
+    });
+
+    run("read_csv_table, 1 thread ", text.size(), [&] {
+        const auto table = nvt::read_csv_table<order_t>(text, 1);
+        double sum = 0;
+        for (double px : table["px"_]) sum += px;
+        return sum;
+    });
+
+    const unsigned threads = std::thread::hardware_concurrency();
+    std::cout << threads << " hardware threads\n";
+    run("read_csv_table, all      ", text.size(), [&] {
+        const auto table = nvt::read_csv_table<order_t>(text);
+        double sum = 0;
+        for (double px : table["px"_]) sum += px;
+        return sum;
+    });
+    return 0;
+}
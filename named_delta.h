@@ -0,0 +1,181 @@
+#pragma once
+
+#include <field_mask.h>
+#include <named_serialize.h>
+#include <named_tuple.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// field-wise delta of named tuples:
+//
+//   auto patch = nvt::diff(before, after);    // mask of changed fields
+//   nvt::apply(replica, patch);               // assigns the changed fields
+//   nvt::serialize(patch, nvt::vector_sink{buf});
+//
+// A named_patch holds a field_mask with one bit per field and the new values
+// of the masked fields. apply() walks the set bits only, so a patch of 2 of
+// 40 fields costs 2 assignments. In memory the values are a full tuple, the
+// unmasked fields default constructed, so each field keeps its type and
+// offset; only the wire encoding is compact. On the wire a patch is the
+// mask, (N + 7) / 8 bytes with bit i of byte i / 8 for field i, followed by
+// the named_serialize encoding of the masked fields in declaration order.
+
+namespace nvtuple_ns {
+
+// named_patch - the changed fields of a named tuple and their new values
+
+template<typename... TS>
+class named_patch {
+   public:
+    using tuple_type = named_tuple<TS...>;
+    using mask_type = field_mask<sizeof...(TS)>;
+
+    const mask_type& mask() const noexcept { return _mask; }
+    const tuple_type& values() const noexcept { return _values; }
+
+    template<typename T>
+    bool changed() const noexcept {
+        return _mask.test(std::size_t(tuple_type::template get_index<T>()));
+    }
+
+    // add a field to the patch
+    template<typename NV>
+    named_patch& set(const NV& nv) {
+        _mask.set(std::size_t(
+            tuple_type::template get_index<typename NV::namedtype>()));
+        _values[typename NV::namedtype{}] = nv.get();
+        return *this;
+    }
+
+    template<typename NV>
+    named_patch& operator<<(const NV& nv) {
+        return set(nv);
+    }
+
+   private:
+    template<typename... ST>
+    friend named_patch<ST...> diff(const named_tuple<ST...>& a,
+                                   const named_tuple<ST...>& b);
+    template<typename... ST>
+    friend bool deserialize(buffer_source& src, named_patch<ST...>& patch);
+
+    mask_type _mask{};
+    tuple_type _values{};
+};
+
+namespace delta_detail {
+
+template<typename T>
+bool values_equal(const T& a, const T& b);
+
+template<typename... TS>
+bool tuples_equal(const named_tuple<TS...>& a, const named_tuple<TS...>& b) {
+    return (... && values_equal(a[typename TS::namedtype{}].get(),
+                                b[typename TS::namedtype{}].get()));
+}
+
+template<typename T>
+bool values_equal(const T& a, const T& b) {
+    if constexpr (is_named_tuple<T>::value)
+        return tuples_equal(a, b);
+    else
+        return a == b;
+}
+
+}  // namespace delta_detail
+
+// diff - the fields of b that differ from a
+template<typename... TS>
+named_patch<TS...> diff(const named_tuple<TS...>& a,
+                        const named_tuple<TS...>& b) {
+    named_patch<TS...> patch;
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (...,
+         (delta_detail::values_equal(std::get<I>(a).get(),
+                                     std::get<I>(b).get())
+              ? void()
+              : (patch._mask.set(I),
+                 void(std::get<I>(patch._values) = std::get<I>(b)))));
+    }(std::index_sequence_for<TS...>{});
+    return patch;
+}
+
+// apply - assign the fields of the patch to target, the other fields are
+// not touched
+template<typename... TS>
+named_tuple<TS...>& apply(named_tuple<TS...>& target,
+                          const named_patch<TS...>& patch) {
+    for_each_masked(patch.mask(), [&](auto i) {
+        constexpr std::size_t I = decltype(i)::value;
+        std::get<I>(target) = std::get<I>(patch.values());
+    });
+    return target;
+}
+
+// binary delta encoding
+
+template<typename... TS>
+std::size_t serialized_size(const named_patch<TS...>& patch) noexcept {
+    std::size_t n = field_mask<sizeof...(TS)>::byte_size;
+    for_each_masked(patch.mask(), [&](auto i) {
+        constexpr std::size_t I = decltype(i)::value;
+        n += serial_detail::size_of(std::get<I>(patch.values()).get());
+    });
+    return n;
+}
+
+// false, with nothing written, when a masked string is too long for the
+// uint32_t length or the sink is full
+template<typename Sink, typename... TS>
+bool serialize(const named_patch<TS...>& patch, Sink&& sink) {
+    bool fit = true;
+    for_each_masked(patch.mask(), [&](auto i) {
+        constexpr std::size_t I = decltype(i)::value;
+        fit = fit &&
+              serial_detail::lengths_fit(std::get<I>(patch.values()).get());
+    });
+    if (!fit) return false;
+    std::byte* p = sink.reserve(serialized_size(patch));
+    if (!p) return false;
+    using mask_type = field_mask<sizeof...(TS)>;
+    for (std::size_t b = 0; b < mask_type::byte_size; ++b)
+        *p++ = std::byte(patch.mask().byte(b));
+    for_each_masked(patch.mask(), [&](auto i) {
+        constexpr std::size_t I = decltype(i)::value;
+        serial_detail::write(p, std::get<I>(patch.values()).get());
+    });
+    return true;
+}
+
+// decode a patch, false if the source is too short or the mask has bits
+// past the last field; patch is assigned only when the whole patch decoded
+template<typename... TS>
+bool deserialize(buffer_source& src, named_patch<TS...>& patch) {
+    using mask_type = field_mask<sizeof...(TS)>;
+    const std::byte* p = src.take(mask_type::byte_size);
+    if (!p && mask_type::byte_size) return false;
+    mask_type mask;
+    for (std::size_t b = 0; b < mask_type::byte_size; ++b)
+        mask.set_byte(b, std::uint8_t(p[b]));
+    if constexpr (sizeof...(TS) % 8 != 0) {
+        if (mask_type::byte_size &&
+            (std::uint8_t(p[mask_type::byte_size - 1]) >> (sizeof...(TS) % 8)))
+            return false;
+    }
+    bool ok = true;
+    typename named_patch<TS...>::tuple_type values;
+    for_each_masked(mask, [&](auto i) {
+        constexpr std::size_t I = decltype(i)::value;
+        ok = ok && serial_detail::read(src, std::get<I>(values).get());
+    });
+    if (!ok) return false;
+    patch._mask = mask;
+    patch._values = std::move(values);
+    return true;
+}
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+
+// allocation free text formatting of named tuples, producing the same text as
+// operator<<(std::ostream&, ...) with a default formatted stream:
+//
+//   char buf[256];
+//   auto [end, ec] = nvt::format_to(buf, buf + sizeof(buf), t);
+//
+// Numbers are written with std::to_chars (floating point as "%g", the stream
+// default). The constant text around the values, "(name: " and ", name: "
+// with the string quotes, is built at compile time from the named_type
+// characters, so every field costs one memcpy plus its value.
+
+namespace nvtuple_ns {
+
+namespace format_detail {
+
+template<typename E, typename = void>
+struct element {
+    static constexpr bool named = false;
+    static constexpr std::string_view name{};
+    using value_type = E;
+    static const E& value(const E& e) noexcept { return e; }
+};
+
+template<typename E>
+struct element<E, std::void_t<decltype(E::is_a_named_value())>> {
+    static constexpr bool named = true;
+    static constexpr std::string_view name = E::namedtype::_name_sv;
+    using value_type = typename E::type;
+    static decltype(auto) value(const E& e) noexcept { return e.get(); }
+};
+
+// the operator<< of named values quotes string like values
+template<typename E>
+constexpr bool quoted =
+    element<E>::named && is_string_like_v<typename element<E>::value_type>;
+
+// text before element I of a tuple: the closing quote of the previous
+// element, "(" or ", ", the "name: " and the opening quote.
+
+template<std::size_t I, typename... ES>
+struct prefix {
+    using E = std::tuple_element_t<I, std::tuple<ES...>>;
+    static constexpr bool prev_quoted = [] {
+        if constexpr (I == 0)
+            return false;
+        else
+            return quoted<std::tuple_element_t<I - 1, std::tuple<ES...>>>;
+    }();
+    static constexpr std::size_t size =
+        (prev_quoted ? 1 : 0) + (I == 0 ? 1 : 2) +
+        (element<E>::named ? element<E>::name.size() + 2 : 0) +
+        (quoted<E> ? 1 : 0);
+    static constexpr std::array<char, size> text = [] {
+        std::array<char, size> a{};
+        std::size_t n = 0;
+        if (prev_quoted) a[n++] = '"';
+        if (I == 0) {
+            a[n++] = '(';
+        } else {
+            a[n++] = ',';
+            a[n++] = ' ';
+        }
+        if (element<E>::named) {
+            for (char c : element<E>::name) a[n++] = c;
+            a[n++] = ':';
+            a[n++] = ' ';
+        }
+        if (quoted<E>) a[n++] = '"';
+        return a;
+    }();
+};
+
+template<typename... ES>
+struct suffix {
+    static constexpr bool last_quoted = [] {
+        if constexpr (sizeof...(ES) == 0)
+            return false;
+        else
+            return quoted<
+                std::tuple_element_t<sizeof...(ES) - 1, std::tuple<ES...>>>;
+    }();
+    static constexpr std::array<char, last_quoted ? 2 : 1> text = [] {
+        std::array<char, last_quoted ? 2 : 1> a{};
+        if (last_quoted) a[0] = '"';
+        a[a.size() - 1] = ')';
+        return a;
+    }();
+    // an empty tuple prints as "()"
+    static constexpr std::array<char, 2> empty{'(', ')'};
+};
+
+struct writer {
+    char* p;
+    char* last;
+    bool ok{true};
+
+    void put(const char* s, std::size_t n) noexcept {
+        if (ok && std::size_t(last - p) >= n) {
+            std::memcpy(p, s, n);
+            p += n;
+        } else {
+            ok = false;
+        }
+    }
+
+    template<std::size_t N>
+    void put(const std::array<char, N>& a) noexcept {
+        put(a.data(), N);
+    }
+
+    template<typename... Args>
+    void number(Args... args) noexcept {
+        if (!ok) return;
+        auto r = std::to_chars(p, last, args...);
+        if (r.ec == std::errc{})
+            p = r.ptr;
+        else
+            ok = false;
+    }
+};
+
+template<typename... ES>
+std::true_type is_tuple_test(const std::tuple<ES...>*);
+std::false_type is_tuple_test(...);
+
+// std::tuple and named_tuple (derived from std::tuple) values
+template<typename T>
+constexpr bool is_tuple =
+    decltype(is_tuple_test(static_cast<const T*>(nullptr)))::value;
+
+template<typename... ES>
+const std::tuple<ES...>& as_tuple(const std::tuple<ES...>& t) noexcept {
+    return t;
+}
+
+template<typename T>
+constexpr bool is_char =
+    std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+    std::is_same<T, unsigned char>::value;
+
+template<typename T>
+constexpr bool is_c_string =
+    std::is_same<T, const char*>::value || std::is_same<T, char*>::value;
+
+template<typename... ES>
+void format_tuple(writer& w, const std::tuple<ES...>& t) noexcept;
+
+template<typename... ES>
+std::size_t tuple_size_bound(const std::tuple<ES...>& t) noexcept;
+
+template<typename T>
+void format_value(writer& w, const T& v) noexcept {
+    if constexpr (is_tuple<T>) {
+        format_tuple(w, as_tuple(v));
+    } else if constexpr (std::is_same<T, bool>::value) {
+        w.put(v ? "1" : "0", 1);
+    } else if constexpr (is_char<T>) {
+        const char c = char(v);
+        w.put(&c, 1);
+    } else if constexpr (std::is_floating_point<T>::value) {
+        w.number(v, std::chars_format::general, 6);
+    } else if constexpr (std::is_integral<T>::value) {
+        w.number(v);
+    } else if constexpr (is_std_string<T>::value ||
+                         std::is_same<T, std::string_view>::value ||
+                         is_fixed_string<T>::value) {
+        w.put(v.data(), v.size());
+    } else if constexpr (is_c_string<T>) {
+        w.put(v, std::strlen(v));
+    } else if constexpr (std::is_pointer<T>::value) {
+        const auto u = reinterpret_cast<std::uintptr_t>(v);
+        if (!u) {
+            w.put("0", 1);
+        } else {
+            w.put("0x", 2);
+            w.number(u, 16);
+        }
+    } else {
+        static_assert(is_tuple<T>, "no text format for this value type");
+    }
+}
+
+template<typename T>
+std::size_t value_size_bound(const T& v) noexcept {
+    if constexpr (is_tuple<T>) {
+        return tuple_size_bound(as_tuple(v));
+    } else if constexpr (std::is_same<T, bool>::value || is_char<T>) {
+        return 1;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        // sign, 6 digits, '.', "e-4951"
+        return 16;
+    } else if constexpr (std::is_integral<T>::value) {
+        return std::numeric_limits<T>::digits10 + 2;
+    } else if constexpr (is_std_string<T>::value ||
+                         std::is_same<T, std::string_view>::value ||
+                         is_fixed_string<T>::value) {
+        return v.size();
+    } else if constexpr (is_c_string<T>) {
+        return std::strlen(v);
+    } else {
+        return 2 + 2 * sizeof(void*);
+    }
+}
+
+template<typename... ES, std::size_t... I>
+void format_elements(writer& w, const std::tuple<ES...>& t,
+                     std::index_sequence<I...>) noexcept {
+    (..., (w.put(prefix<I, ES...>::text),
+           format_value(w, element<ES>::value(std::get<I>(t)))));
+}
+
+template<typename... ES>
+void format_tuple(writer& w, const std::tuple<ES...>& t) noexcept {
+    if constexpr (sizeof...(ES) == 0) {
+        w.put(suffix<>::empty);
+    } else {
+        format_elements(w, t, std::index_sequence_for<ES...>{});
+        w.put(suffix<ES...>::text);
+    }
+}
+
+template<typename... ES, std::size_t... I>
+std::size_t elements_size_bound(const std::tuple<ES...>& t,
+                                std::index_sequence<I...>) noexcept {
+    return (std::size_t(0) + ... +
+            (prefix<I, ES...>::size +
+             value_size_bound(element<ES>::value(std::get<I>(t)))));
+}
+
+template<typename... ES>
+std::size_t tuple_size_bound(const std::tuple<ES...>& t) noexcept {
+    return elements_size_bound(t, std::index_sequence_for<ES...>{}) +
+           suffix<ES...>::text.size() + 1;
+}
+
+}  // namespace format_detail
+
+// format_size - upper bound of the number of characters format_to() writes
+
+template<typename... ES>
+std::size_t format_size(const std::tuple<ES...>& t) noexcept {
+    return format_detail::tuple_size_bound(t);
+}
+
+// format_to - write the text of t to [first, last), returns the end of the
+// text, or {last, std::errc::value_too_large} if it does not fit.
+
+template<typename... ES>
+std::to_chars_result format_to(char* first, char* last,
+                               const std::tuple<ES...>& t) noexcept {
+    format_detail::writer w{first, last};
+    format_detail::format_tuple(w, t);
+    if (!w.ok) return {last, std::errc::value_too_large};
+    return {w.p, std::errc{}};
+}
+
+template<typename... ES>
+std::string format(const std::tuple<ES...>& t) {
+    std::string s(format_size(t), '\0');
+    auto r = format_to(s.data(), s.data() + s.size(), t);
+    s.resize(std::size_t(r.ptr - s.data()));
+    return s;
+}
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <hash_index.h>
+#include <named_table.h>
+#include <named_tuple.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// group by / aggregation over named tuple collections:
+//
+//   auto report = nvt::group_by<"sym"_>(orders).agg(
+//       nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count);
+//   report["qty_sum"_][0], report["px_max"_][0], report["count"_][0]
+//
+// The rows are a random access range of named tuples (std::vector, span) or
+// a named_table. The result is a named_table of the key fields followed by
+// one column per aggregate, named at compile time with the named_type
+// operator+: "qty"_ + "_sum"_. sum<> takes arithmetic fields, not bool or
+// enum ones; sums of integers are std::int64_t (or std::uint64_t), of
+// floating point values double. min and max keep the field type, count is
+// std::size_t. The key and min / max columns copy the field values: with
+// std::string_view fields they view the characters of the rows, and the
+// result must not outlive the rows.
+//
+// The default hash path splits the rows in contiguous ranges across threads
+// (threads(n), 0: the hardware concurrency), aggregates each range into a
+// thread local table indexed by a hash_index on the keys, and merges the
+// partial tables in range order: the groups come out in the order of their
+// first row. sorted() aggregates runs of equal keys after a stable sort of
+// the row order instead, skipped for rows already in key order, and its
+// groups come out in key order.
+
+namespace nvtuple_ns {
+
+namespace group_detail {
+
+// row i of a range of tuples, or a named_row of a named_table
+template<typename Rows>
+decltype(auto) row_at(const Rows& rows, std::size_t i) {
+    if constexpr (requires { rows.row(i); })
+        return rows.row(i);
+    else
+        return rows[i];
+}
+
+template<typename Rows>
+using row_t = decltype(row_at(std::declval<const Rows&>(), 0));
+
+template<typename Row, typename NT>
+using field_t = std::remove_cvref_t<decltype(hash_detail::key_value(
+    std::declval<Row>()[NT{}]))>;
+
+template<typename V>
+struct sum_type {
+    static_assert(std::is_arithmetic<V>::value &&
+                      !std::is_same<V, bool>::value,
+                  "sum<> needs an arithmetic, non bool field");
+    using type = std::conditional_t<
+        std::is_floating_point<V>::value, double,
+        std::conditional_t<std::is_signed<V>::value, std::int64_t,
+                           std::uint64_t>>;
+};
+
+template<typename V>
+using sum_t = typename sum_type<V>::type;
+
+// an aggregate: the result column name and value type, the value of the
+// first row of a group, the update by a row, and the merge of two partials
+
+template<typename NT>
+struct sum_agg {
+    using name_type = decltype(NT{} + "_sum"_);
+    template<typename Row>
+    using value_type = sum_t<field_t<Row, NT>>;
+
+    template<typename V, typename Row>
+    static V first(const Row& r) {
+        return V(hash_detail::key_value(r[NT{}]));
+    }
+    template<typename V, typename Row>
+    static void update(V& acc, const Row& r) {
+        acc += V(hash_detail::key_value(r[NT{}]));
+    }
+    template<typename V>
+    static void merge(V& acc, const V& other) {
+        acc += other;
+    }
+};
+
+template<typename NT>
+struct max_agg {
+    using name_type = decltype(NT{} + "_max"_);
+    template<typename Row>
+    using value_type = field_t<Row, NT>;
+
+    template<typename V, typename Row>
+    static V first(const Row& r) {
+        return hash_detail::key_value(r[NT{}]);
+    }
+    template<typename V, typename Row>
+    static void update(V& acc, const Row& r) {
+        merge(acc, V(hash_detail::key_value(r[NT{}])));
+    }
+    template<typename V>
+    static void merge(V& acc, const V& other) {
+        if (acc < other) acc = other;
+    }
+};
+
+template<typename NT>
+struct min_agg {
+    using name_type = decltype(NT{} + "_min"_);
+    template<typename Row>
+    using value_type = field_t<Row, NT>;
+
+    template<typename V, typename Row>
+    static V first(const Row& r) {
+        return hash_detail::key_value(r[NT{}]);
+    }
+    template<typename V, typename Row>
+    static void update(V& acc, const Row& r) {
+        merge(acc, V(hash_detail::key_value(r[NT{}])));
+    }
+    template<typename V>
+    static void merge(V& acc, const V& other) {
+        if (other < acc) acc = other;
+    }
+};
+
+struct count_agg {
+    using name_type = decltype("count"_);
+    template<typename Row>
+    using value_type = std::size_t;
+
+    template<typename V, typename Row>
+    static V first(const Row&) {
+        return 1;
+    }
+    template<typename V, typename Row>
+    static void update(V& acc, const Row&) {
+        ++acc;
+    }
+    template<typename V>
+    static void merge(V& acc, const V& other) {
+        acc += other;
+    }
+};
+
+}  // namespace group_detail
+
+// the aggregates of agg(): sum<"qty"_>, min<"px"_>, max<"px"_>, count
+
+template<auto N>
+inline constexpr group_detail::sum_agg<typename decltype(N)::type> sum{};
+
+template<auto N>
+inline constexpr group_detail::min_agg<typename decltype(N)::type> min{};
+
+template<auto N>
+inline constexpr group_detail::max_agg<typename decltype(N)::type> max{};
+
+inline constexpr group_detail::count_agg count{};
+
+// grouping - the rows and the key fields of group_by<K...>(rows)
+
+template<typename Rows, auto... K>
+class grouping {
+    static_assert(sizeof...(K) > 0, "group_by needs at least one key field");
+    using row_type = group_detail::row_t<Rows>;
+
+   public:
+    // the result table of agg(A...)
+    template<typename... A>
+    using result_type = named_table<
+        named_value<group_detail::field_t<row_type, typename decltype(K)::type>,
+                    typename decltype(K)::type>...,
+        named_value<typename A::template value_type<row_type>,
+                    typename A::name_type>...>;
+
+    explicit grouping(const Rows& rows) noexcept : _rows(&rows) {}
+
+    // a grouping of temporary rows would dangle
+    explicit grouping(const Rows&&) = delete;
+
+    // worker threads of the hash path, 0: the hardware concurrency
+    grouping& threads(unsigned n) noexcept {
+        _threads = n;
+        return *this;
+    }
+
+    // aggregate runs of equal keys after sorting, groups in key order
+    grouping& sorted() noexcept {
+        _sorted = true;
+        return *this;
+    }
+
+    template<typename... A>
+    result_type<A...> agg(const A&...) const {
+        if (_sorted) return sorted_agg<A...>();
+        return hash_agg<A...>();
+    }
+
+   private:
+    template<typename Out>
+    using index_type = hash_index<Out, K...>;
+
+    template<typename... A, typename Row>
+    static void add_group(result_type<A...>& out, const Row& r) {
+        (..., out.template column<typename decltype(K)::type>().push_back(
+                  hash_detail::key_value(r[typename decltype(K)::type{}])));
+        (..., out.template column<typename A::name_type>().push_back(
+                  A::template first<typename A::template value_type<row_type>>(
+                      r)));
+    }
+
+    template<typename... A, typename Row>
+    static void update_group(result_type<A...>& out, std::size_t g,
+                             const Row& r) {
+        (..., A::update(out.template column<typename A::name_type>()[g], r));
+    }
+
+    // aggregate the rows [begin, end) into out
+    template<typename... A>
+    void partial(result_type<A...>& out, std::size_t begin,
+                 std::size_t end) const {
+        index_type<result_type<A...>> index{out};
+        for (std::size_t i = begin; i < end; ++i) {
+            decltype(auto) r = group_detail::row_at(*_rows, i);
+            const std::size_t g = index.find(r);
+            if (g == index.npos) {
+                add_group<A...>(out, r);
+                index.update();
+            } else {
+                update_group<A...>(out, g, r);
+            }
+        }
+    }
+
+    template<typename... A>
+    result_type<A...> hash_agg() const {
+        const std::size_t n = std::size(*_rows);
+        // at least 16K rows per thread
+        const std::size_t hw =
+            _threads ? _threads : std::thread::hardware_concurrency();
+        const std::size_t parts = std::clamp<std::size_t>(
+            n >> 14, 1, std::max<std::size_t>(hw, 1));
+
+        std::vector<result_type<A...>> partials(parts);
+        std::vector<std::exception_ptr> errors(parts);
+        const auto work = [&](std::size_t i) {
+            try {
+                partial<A...>(partials[i], n * i / parts,
+                              n * (i + 1) / parts);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> pool;
+        for (std::size_t i = 1; i < parts; ++i) pool.emplace_back(work, i);
+        work(0);
+        for (auto& t : pool) t.join();
+        for (auto& e : errors)
+            if (e) std::rethrow_exception(e);
+
+        // merge the partials into the first, in range order
+        auto& out = partials.front();
+        index_type<result_type<A...>> index{out};
+        for (std::size_t p = 1; p < parts; ++p) {
+            const auto& part = partials[p];
+            for (std::size_t g = 0; g < part.size(); ++g) {
+                const std::size_t o = index.find(part.row(g));
+                if (o == index.npos) {
+                    out.push_back(part.to_tuple(g));
+                    index.update();
+                } else {
+                    (..., A::merge(
+                              out.template column<typename A::name_type>()[o],
+                              part.template column<typename A::name_type>()
+                                  [g]));
+                }
+            }
+        }
+        return std::move(out);
+    }
+
+    template<typename... A>
+    result_type<A...> sorted_agg() const {
+        const auto keys = [&](std::size_t i) {
+            decltype(auto) r = group_detail::row_at(*_rows, i);
+            return std::tuple<const group_detail::field_t<
+                row_type, typename decltype(K)::type>&...>{
+                hash_detail::key_value(r[typename decltype(K)::type{}])...};
+        };
+        std::vector<std::size_t> order(std::size(*_rows));
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        const auto less = [&](std::size_t a, std::size_t b) {
+            return keys(a) < keys(b);
+        };
+        // rows already in key order are not sorted again
+        if (!std::is_sorted(order.begin(), order.end(), less))
+            std::stable_sort(order.begin(), order.end(), less);
+
+        result_type<A...> out;
+        for (std::size_t i : order) {
+            decltype(auto) r = group_detail::row_at(*_rows, i);
+            const std::size_t g = out.size() - 1;
+            if (!out.empty() &&
+                (... && (out.template column<typename decltype(K)::type>()
+                             [g] == hash_detail::key_value(
+                                        r[typename decltype(K)::type{}]))))
+                update_group<A...>(out, g, r);
+            else
+                add_group<A...>(out, r);
+        }
+        return out;
+    }
+
+    const Rows* _rows;
+    unsigned _threads{0};
+    bool _sorted{false};
+};
+
+// group_by<"sym"_, ...>(rows) - the grouping of rows by the key fields
+
+template<auto... K, typename Rows>
+grouping<Rows, K...> group_by(const Rows& rows) noexcept {
+    return grouping<Rows, K...>{rows};
+}
+
+template<auto... K, typename Rows>
+void group_by(const Rows&&) = delete;
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,96 @@
+// Benchmark: per symbol sum, max and count over a std::vector of fill
+// records, a hand written std::unordered_map loop compared to group_by()
+// on the hash path with one and with all hardware threads, and the sorted
+// path.
+
+#include <named_group.h>
+#include <named_tuple.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using fill_t =
+    nvt::named_tuple<nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<double, decltype("px"_)>>;
+
+template<typename F>
+void run(const char* label, std::size_t n, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t groups = f();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::cout << label << ": " << double(ns) / double(n) << " ns/row ("
+              << groups << " groups)\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    const std::size_t symbols = 10000;
+
+    std::vector<fill_t> fills;
+    fills.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        fills.push_back(
+            fill_t{("sym"_, "SYMBOL" + std::to_string(i * 7919 % symbols)),
+                   ("qty"_, int(i % 1000)), ("px"_, double(i % 101))});
+
+    run("unordered_map loop      ", n, [&] {
+        struct acc {
+            std::int64_t qty_sum{0};
+            double px_max{0};
+            std::size_t count{0};
+        };
+        std::unordered_map<std::string, acc> groups;
+        for (const auto& f : fills) {
+            acc& a = groups[f["sym"_].get()];
+            a.qty_sum += f["qty"_].get();
+            a.px_max = a.count ? std::max(a.px_max, f["px"_].get())
+                               : f["px"_].get();
+            ++a.count;
+        }
+        return groups.size();
+    });
+
+    run("group_by hash, 1 thread ", n, [&] {
+        return nvt::group_by<"sym"_>(fills)
+            .threads(1)
+            .agg(nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count)
+            .size();
+    });
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+    run("group_by hash, all      ", n, [&] {
+        return nvt::group_by<"sym"_>(fills)
+            .agg(nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count)
+            .size();
+    });
+
+    run("group_by sorted         ", n, [&] {
+        return nvt::group_by<"sym"_>(fills)
+            .sorted()
+            .agg(nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count)
+            .size();
+    });
+
+    std::sort(fills.begin(), fills.end(), [](const fill_t& a, const fill_t& b) {
+        return a["sym"_].get() < b["sym"_].get();
+    });
+    run("group_by sorted, sorted ", n, [&] {
+        return nvt::group_by<"sym"_>(fills)
+            .sorted()
+            .agg(nvt::sum<"qty"_>, nvt::max<"px"_>, nvt::count)
+            .size();
+    });
+    return 0;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <hash_index.h>
+#include <named_table.h>
+#include <named_tuple.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// name driven hash join of two named tables on shared key fields:
+//
+//   // orders: id, sym, qty    refdata: sym, venue, lot
+//   nvt::join<"sym"_>(orders, refdata, [](const auto& batch) {
+//       // batch: named_table of id, sym, qty, venue, lot
+//   });
+//   auto all = nvt::join_table<"sym"_>(orders, refdata);
+//
+// The result schema, join_tuple_t<Left, Right>, is the fields of the left
+// tuple followed by the right fields with names not in the left tuple; a
+// field in both, the keys included, takes the left value. The right table is
+// the build side, indexed once with a hash_index on the key fields; the left
+// rows are the probe side, split in contiguous ranges across threads that
+// share the read only index. Every left row yields one result row per
+// matching right row (inner join).
+//
+// join() streams the result in batches of up to batch rows, named_tables of
+// the result schema, passed to f from the worker threads concurrently; the
+// rows of a batch are in left row order. join_table() returns the whole
+// result in left row order.
+
+namespace nvtuple_ns {
+
+namespace join_detail {
+
+template<typename NT, typename... TS>
+constexpr bool has_name =
+    (... || std::is_same<NT, typename TS::namedtype>::value);
+
+template<typename NT, typename Tuple>
+struct in_tuple;
+
+template<typename NT, typename... TS>
+struct in_tuple<NT, named_tuple<TS...>>
+    : std::bool_constant<has_name<NT, TS...>> {};
+
+template<typename T>
+struct to_named_tuple;
+
+template<typename... TS>
+struct to_named_tuple<std::tuple<TS...>> {
+    using type = named_tuple<TS...>;
+};
+
+template<typename L, typename R>
+struct join_tuple;
+
+template<typename... LS, typename... RS>
+struct join_tuple<named_tuple<LS...>, named_tuple<RS...>> {
+    using type = typename to_named_tuple<decltype(std::tuple_cat(
+        std::declval<std::tuple<LS...>>(),
+        std::declval<
+            std::conditional_t<has_name<typename RS::namedtype, LS...>,
+                               std::tuple<>, std::tuple<RS>>>()...))>::type;
+};
+
+// append the result row of left row l and right row r to out
+template<typename Out, typename Left, typename Right>
+void append_row(Out& out, const Left& left, std::size_t l, const Right& right,
+                std::size_t r) {
+    [&]<typename... TS>(const named_tuple<TS...>*) {
+        (..., [&] {
+            using NT = typename TS::namedtype;
+            auto& col = out.template column<NT>();
+            if constexpr (in_tuple<NT, typename Left::tuple_type>::value)
+                col.push_back(left.template column<NT>()[l]);
+            else
+                col.push_back(right.template column<NT>()[r]);
+        }());
+    }(static_cast<const typename Out::tuple_type*>(nullptr));
+}
+
+// probe the left rows [begin, end) into out, flush(out) when it holds batch
+// rows, returns the result row count
+template<typename Index, typename Out, typename Left, typename Right,
+         typename Flush>
+std::size_t probe(const Index& index, const Left& left, const Right& right,
+                  std::size_t begin, std::size_t end, Out& out,
+                  std::size_t batch, Flush&& flush) {
+    std::size_t rows = 0;
+    for (std::size_t l = begin; l < end; ++l) {
+        rows += index.for_each(left.row(l), [&](std::size_t r) {
+            append_row(out, left, l, right, r);
+            if (out.size() >= batch) {
+                flush(std::as_const(out));
+                out.clear();
+            }
+        });
+    }
+    return rows;
+}
+
+}  // namespace join_detail
+
+// join_tuple_t<named_tuple<LS...>, named_tuple<RS...>> - the result schema
+
+template<typename L, typename R>
+using join_tuple_t = typename join_detail::join_tuple<L, R>::type;
+
+// join - f(const named_table<result>&) for batches of the joined rows, the
+// left rows probed by up to threads threads (0: the hardware concurrency).
+// Returns the result row count.
+
+template<auto... K, typename... LS, typename... RS, typename F>
+std::size_t join(const named_table<LS...>& left,
+                 const named_table<RS...>& right, F&& f, unsigned threads = 0,
+                 std::size_t batch = 4096) {
+    static_assert(sizeof...(K) > 0, "join needs at least one key field");
+    using result_t = table_for_t<
+        join_tuple_t<named_tuple<LS...>, named_tuple<RS...>>>;
+    const hash_index<named_table<RS...>, K...> index{right};
+
+    // at least 16K left rows per thread
+    const std::size_t hw =
+        threads ? threads : std::thread::hardware_concurrency();
+    const std::size_t parts = std::clamp<std::size_t>(
+        left.size() >> 14, 1, std::max<std::size_t>(hw, 1));
+    batch = std::max<std::size_t>(batch, 1);
+
+    std::vector<std::size_t> rows(parts);
+    std::vector<std::exception_ptr> errors(parts);
+    const auto work = [&](std::size_t i) {
+        try {
+            result_t out;
+            out.reserve(batch);
+            rows[i] = join_detail::probe(index, left, right,
+                                         left.size() * i / parts,
+                                         left.size() * (i + 1) / parts, out,
+                                         batch, f);
+            if (!out.empty()) f(std::as_const(out));
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t i = 1; i < parts; ++i) pool.emplace_back(work, i);
+    work(0);
+    for (auto& t : pool) t.join();
+    for (auto& e : errors)
+        if (e) std::rethrow_exception(e);
+    std::size_t total = 0;
+    for (std::size_t n : rows) total += n;
+    return total;
+}
+
+// join_table - the joined rows as one named_table, in left row order
+
+template<auto... K, typename... LS, typename... RS>
+auto join_table(const named_table<LS...>& left,
+                const named_table<RS...>& right) {
+    static_assert(sizeof...(K) > 0, "join needs at least one key field");
+    table_for_t<join_tuple_t<named_tuple<LS...>, named_tuple<RS...>>> out;
+    const hash_index<named_table<RS...>, K...> index{right};
+    join_detail::probe(index, left, right, 0, left.size(), out,
+                       std::size_t(-1), [](const auto&) {});
+    return out;
+}
+
+}  // namespace nvtuple_ns
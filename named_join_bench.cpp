@@ -0,0 +1,82 @@
+// Benchmark: enrichment of order rows with reference data by symbol, a
+// std::unordered_map lookup per order appending to a std::vector of result
+// tuples compared to join() streaming batches, with one and with all
+// hardware threads.
+
+#include <named_join.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<std::string, decltype("sym"_)>,
+                     nvt::named_value<int, decltype("qty"_)>,
+                     nvt::named_value<double, decltype("px"_)>>;
+using ref_t = nvt::named_tuple<nvt::named_value<std::string, decltype("sym"_)>,
+                               nvt::named_value<int, decltype("lot"_)>,
+                               nvt::named_value<double, decltype("tick"_)>>;
+using result_t = nvt::join_tuple_t<order_t, ref_t>;
+
+template<typename F>
+void run(const char* label, std::size_t n, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t rows = f();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::cout << label << ": " << double(ns) / double(n) << " ns/order ("
+              << rows << " rows)\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    const std::size_t symbols = 10000;
+
+    nvt::table_for_t<ref_t> refdata;
+    for (std::size_t s = 0; s < symbols; ++s)
+        refdata.push_back(ref_t{("sym"_, "SYMBOL" + std::to_string(s)),
+                                ("lot"_, 100), ("tick"_, 0.01)});
+    nvt::table_for_t<order_t> orders;
+    orders.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        orders.push_back(order_t{("id"_, int(i)),
+                                 ("sym"_, refdata["sym"_][i * 7919 % symbols]),
+                                 ("qty"_, 10), ("px"_, 1.5)});
+
+    run("unordered_map + vector  ", n, [&] {
+        std::unordered_map<std::string, std::size_t> by_sym;
+        for (std::size_t r = 0; r < refdata.size(); ++r)
+            by_sym.emplace(refdata["sym"_][r], r);
+        std::vector<result_t> out;
+        for (std::size_t i = 0; i < orders.size(); ++i) {
+            const auto it = by_sym.find(orders["sym"_][i]);
+            if (it == by_sym.end()) continue;
+            result_t r;
+            r << orders.to_tuple(i) << refdata.to_tuple(it->second);
+            out.push_back(std::move(r));
+        }
+        return out.size();
+    });
+
+    run("join, 1 thread, batches ", n, [&] {
+        return nvt::join<"sym"_>(
+            orders, refdata, [](const auto&) {}, 1);
+    });
+
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+    run("join, all, batches      ", n, [&] {
+        return nvt::join<"sym"_>(orders, refdata, [](const auto&) {});
+    });
+    return 0;
+}
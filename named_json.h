@@ -0,0 +1,477 @@
+#pragma once
+
+#include <exception_tuple.h>
+#include <named_tuple.h>
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+// JSON text for named tuples:
+//
+//   std::string out;
+//   nvt::to_json(t, out);  // {"id":7,"sym":"AAPL","book":{"px":10.5}}
+//   auto t2 = nvt::from_json<decltype(t)>(out);
+//
+// to_json() appends to the caller's string, the '{"name":' / ',"name":' text
+// of every field is escaped and built at compile time from the named_type
+// characters. from_json() is a single pass parser, object keys are matched
+// to fields with the compile time perfect hash name_index<>. Keys that are
+// not fields are skipped without allocation, fields missing from the text
+// keep their default value. Errors throw an exception_tuple with the error
+// text and the offset in the input.
+//
+// JSON has no NaN or infinity: a non finite floating point value is written
+// as null, and null is read back as a quiet NaN, so an infinity does not
+// round trip.
+
+namespace nvtuple_ns {
+
+namespace json_detail {
+
+constexpr const char hex_digits[] = "0123456789abcdef";
+
+// length of the escaped text of c, 1 for characters written as is
+constexpr std::size_t escaped_size(char c) noexcept {
+    switch (c) {
+        case '"':
+        case '\\':
+        case '\b':
+        case '\f':
+        case '\n':
+        case '\r':
+        case '\t':
+            return 2;
+        default:
+            return std::uint8_t(c) < 0x20 ? 6 : 1;
+    }
+}
+
+template<typename Out>
+constexpr void escape_char(Out&& out, char c) noexcept {
+    switch (c) {
+        case '"': out('\\'), out('"'); break;
+        case '\\': out('\\'), out('\\'); break;
+        case '\b': out('\\'), out('b'); break;
+        case '\f': out('\\'), out('f'); break;
+        case '\n': out('\\'), out('n'); break;
+        case '\r': out('\\'), out('r'); break;
+        case '\t': out('\\'), out('t'); break;
+        default:
+            if (std::uint8_t(c) < 0x20) {
+                out('\\'), out('u'), out('0'), out('0');
+                out(hex_digits[std::uint8_t(c) >> 4]);
+                out(hex_digits[std::uint8_t(c) & 0xf]);
+            } else {
+                out(c);
+            }
+    }
+}
+
+// '{"name":' for the first field, ',"name":' for the others
+
+template<bool First, typename NT>
+struct key_text {
+    static constexpr std::size_t size = [] {
+        std::size_t n = 4;
+        for (char c : NT::_name_sv) n += escaped_size(c);
+        return n;
+    }();
+    static constexpr std::array<char, size> text = [] {
+        std::array<char, size> a{};
+        std::size_t n = 0;
+        a[n++] = First ? '{' : ',';
+        a[n++] = '"';
+        for (char c : NT::_name_sv)
+            escape_char([&](char e) { a[n++] = e; }, c);
+        a[n++] = '"';
+        a[n++] = ':';
+        return a;
+    }();
+};
+
+inline void write_string(std::string& out, std::string_view s) {
+    out += '"';
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        if (escaped_size(s[i]) == 1) continue;
+        out.append(s.data() + run, i - run);
+        escape_char([&](char e) { out += e; }, s[i]);
+        run = i + 1;
+    }
+    out.append(s.data() + run, s.size() - run);
+    out += '"';
+}
+
+template<typename... TS>
+void write_object(std::string& out, const named_tuple<TS...>& t);
+
+template<typename T>
+void write_value(std::string& out, const T& v) {
+    if constexpr (is_named_tuple<T>::value) {
+        write_object(out, v);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        out += v ? "true" : "false";
+    } else if constexpr (std::is_same<T, char>::value) {
+        write_string(out, std::string_view(&v, 1));
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        if constexpr (std::is_floating_point<T>::value) {
+            if (!std::isfinite(v)) {
+                out += "null";
+                return;
+            }
+        }
+        char buf[64];
+        auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, r.ptr);
+    } else if constexpr (is_string_like_v<T>) {
+        write_string(out, v);
+    } else {
+        static_assert(is_string_like_v<T>,
+                      "no JSON encoding for this value type");
+    }
+}
+
+template<typename... TS, std::size_t... I>
+void write_fields(std::string& out, const named_tuple<TS...>& t,
+                  std::index_sequence<I...>) {
+    (..., (out.append(key_text<I == 0, typename TS::namedtype>::text.data(),
+                      key_text<I == 0, typename TS::namedtype>::size),
+           write_value(out, t[typename TS::namedtype{}].get())));
+}
+
+template<typename... TS>
+void write_object(std::string& out, const named_tuple<TS...>& t) {
+    if constexpr (sizeof...(TS) == 0) {
+        out += "{}";
+    } else {
+        write_fields(out, t, std::index_sequence_for<TS...>{});
+        out += '}';
+    }
+}
+
+class parser {
+   public:
+    // nesting limit of the skipped values of unknown keys
+    static constexpr unsigned max_depth = 256;
+
+    parser(std::string_view text) noexcept
+        : _begin(text.data()),
+          _p(text.data()),
+          _end(text.data() + text.size()) {}
+
+    [[noreturn]] void fail(const char* error) const {
+        throw NVT_EXCEPTION(("error"_, error),
+                            ("offset"_, std::size_t(_p - _begin)));
+    }
+
+    void ws() noexcept {
+        while (_p != _end &&
+               (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r'))
+            ++_p;
+    }
+
+    bool at_end() noexcept {
+        ws();
+        return _p == _end;
+    }
+
+    bool peek(char c) noexcept {
+        ws();
+        return _p != _end && *_p == c;
+    }
+
+    void expect(char c) {
+        if (!peek(c)) fail("unexpected character");
+        ++_p;
+    }
+
+    bool literal(std::string_view word) noexcept {
+        ws();
+        if (std::size_t(_end - _p) < word.size() ||
+            std::memcmp(_p, word.data(), word.size()) != 0)
+            return false;
+        _p += word.size();
+        return true;
+    }
+
+    // string without escapes, as a view of the input, or with escapes
+    // decoded into scratch, which is only used when there are escapes
+    std::string_view string(std::string& scratch) {
+        expect('"');
+        const char* start = _p;
+        while (_p != _end && *_p != '"' && *_p != '\\') ++_p;
+        if (_p == _end) fail("unterminated string");
+        if (*_p == '"') return {start, std::size_t(_p++ - start)};
+        scratch.assign(start, _p);
+        while (_p != _end && *_p != '"') {
+            if (*_p != '\\') {
+                scratch += *_p++;
+                continue;
+            }
+            if (++_p == _end) break;
+            switch (*_p++) {
+                case '"': scratch += '"'; break;
+                case '\\': scratch += '\\'; break;
+                case '/': scratch += '/'; break;
+                case 'b': scratch += '\b'; break;
+                case 'f': scratch += '\f'; break;
+                case 'n': scratch += '\n'; break;
+                case 'r': scratch += '\r'; break;
+                case 't': scratch += '\t'; break;
+                case 'u': unicode(scratch); break;
+                default: fail("invalid escape");
+            }
+        }
+        if (_p == _end) fail("unterminated string");
+        ++_p;
+        return scratch;
+    }
+
+    // object key, keys with escapes are decoded into a bounded stack buffer,
+    // longer ones can not be field names and are returned empty.
+    std::string_view key(char (&buf)[256]) {
+        expect('"');
+        const char* start = _p;
+        while (_p != _end && *_p != '"' && *_p != '\\') ++_p;
+        if (_p == _end) fail("unterminated string");
+        if (*_p == '"') return {start, std::size_t(_p++ - start)};
+        _p = start - 1;
+        thread_local std::string scratch;
+        auto s = string(scratch);
+        if (s.size() > sizeof(buf)) return {};
+        std::memcpy(buf, s.data(), s.size());
+        return {buf, s.size()};
+    }
+
+    template<typename T>
+    void number(T& v) {
+        ws();
+        if (_p != _end && *_p == '+') fail("invalid number");
+        std::from_chars_result r;
+        if constexpr (std::is_floating_point<T>::value) {
+            if (literal("null")) {
+                v = std::numeric_limits<T>::quiet_NaN();
+                return;
+            }
+            r = std::from_chars(_p, _end, v, std::chars_format::general);
+        } else {
+            r = std::from_chars(_p, _end, v);
+        }
+        if (r.ec != std::errc{}) fail("invalid number");
+        _p = r.ptr;
+        if (_p != _end && (*_p == '.' || *_p == 'e' || *_p == 'E'))
+            fail("invalid integer");
+    }
+
+    void skip_value(unsigned depth = 0) {
+        ws();
+        if (_p == _end) fail("unexpected end of input");
+        switch (*_p) {
+            case '"': {
+                ++_p;
+                while (_p != _end && *_p != '"')
+                    if (*_p++ == '\\' && _p != _end) ++_p;
+                if (_p == _end) fail("unterminated string");
+                ++_p;
+                return;
+            }
+            case '{':
+            case '[': {
+                if (depth == max_depth) fail("nesting too deep");
+                const char close = *_p == '{' ? '}' : ']';
+                ++_p;
+                if (peek(close)) {
+                    ++_p;
+                    return;
+                }
+                for (;;) {
+                    if (close == '}') {
+                        skip_value(depth + 1);  // key
+                        expect(':');
+                    }
+                    skip_value(depth + 1);
+                    if (peek(',')) {
+                        ++_p;
+                        continue;
+                    }
+                    expect(close);
+                    return;
+                }
+            }
+            default: {
+                if (literal("true") || literal("false") || literal("null"))
+                    return;
+                double d;
+                number(d);
+            }
+        }
+    }
+
+   private:
+    unsigned hex4() {
+        if (_end - _p < 4) fail("invalid unicode escape");
+        unsigned u = 0;
+        auto r = std::from_chars(_p, _p + 4, u, 16);
+        if (r.ptr != _p + 4) fail("invalid unicode escape");
+        _p += 4;
+        return u;
+    }
+
+    void unicode(std::string& out) {
+        unsigned cp = hex4();
+        if (cp >= 0xd800 && cp < 0xdc00 && _end - _p >= 2 && _p[0] == '\\' &&
+            _p[1] == 'u') {
+            _p += 2;
+            const unsigned lo = hex4();
+            if (lo < 0xdc00 || lo >= 0xe000) fail("invalid surrogate pair");
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+        }
+        if (cp < 0x80) {
+            out += char(cp);
+        } else if (cp < 0x800) {
+            out += char(0xc0 | (cp >> 6));
+            out += char(0x80 | (cp & 0x3f));
+        } else if (cp < 0x10000) {
+            out += char(0xe0 | (cp >> 12));
+            out += char(0x80 | ((cp >> 6) & 0x3f));
+            out += char(0x80 | (cp & 0x3f));
+        } else {
+            out += char(0xf0 | (cp >> 18));
+            out += char(0x80 | ((cp >> 12) & 0x3f));
+            out += char(0x80 | ((cp >> 6) & 0x3f));
+            out += char(0x80 | (cp & 0x3f));
+        }
+    }
+
+    const char* _begin;
+    const char* _p;
+    const char* _end;
+};
+
+template<typename... TS>
+void read_object(parser& p, named_tuple<TS...>& t);
+
+template<typename T>
+void read_value(parser& p, T& v) {
+    if constexpr (is_named_tuple<T>::value) {
+        read_object(p, v);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        if (p.literal("true"))
+            v = true;
+        else if (p.literal("false"))
+            v = false;
+        else
+            p.fail("expected true or false");
+    } else if constexpr (std::is_same<T, char>::value) {
+        std::string scratch;
+        auto s = p.string(scratch);
+        if (s.size() != 1) p.fail("expected a one character string");
+        v = s[0];
+    } else if constexpr (std::is_arithmetic<T>::value) {
+        p.number(v);
+    } else if constexpr (std::is_same<T, std::string>::value) {
+        auto s = p.string(v);
+        if (s.data() != v.data()) v.assign(s.data(), s.size());
+    } else if constexpr (is_std_string<T>::value) {
+        // other allocators, std::pmr::string
+        std::string scratch;
+        auto s = p.string(scratch);
+        v.assign(s.data(), s.size());
+    } else if constexpr (std::is_same<T, std::string_view>::value) {
+        // a view of the input text, valid as long as the text
+        std::string scratch;
+        auto s = p.string(scratch);
+        if (s.data() == scratch.data())
+            p.fail("string with escapes read into a string_view");
+        v = s;
+    } else if constexpr (is_fixed_string<T>::value) {
+        std::string scratch;
+        if (!v.assign(p.string(scratch))) p.fail("string too long");
+    } else {
+        static_assert(std::is_same<T, std::string>::value,
+                      "no JSON decoding for this value type");
+    }
+}
+
+template<typename Tuple, std::size_t I>
+void read_field(parser& p, Tuple& t) {
+    read_value(p, std::get<I>(t).get());
+}
+
+template<typename... TS, std::size_t... I>
+constexpr auto field_readers(std::index_sequence<I...>) noexcept {
+    return std::array<void (*)(parser&, named_tuple<TS...>&), sizeof...(TS)>{
+        &read_field<named_tuple<TS...>, I>...};
+}
+
+template<typename... TS>
+void read_object(parser& p, named_tuple<TS...>& t) {
+    using index = name_index<typename TS::namedtype...>;
+    static constexpr auto readers =
+        field_readers<TS...>(std::index_sequence_for<TS...>{});
+    p.expect('{');
+    if (p.peek('}')) {
+        p.expect('}');
+        return;
+    }
+    char buf[256];
+    for (;;) {
+        const auto k = p.key(buf);
+        p.expect(':');
+        const int i = index::find(k);
+        if (i >= 0)
+            readers[std::size_t(i)](p, t);
+        else
+            p.skip_value();
+        if (p.peek(',')) {
+            p.expect(',');
+            continue;
+        }
+        p.expect('}');
+        return;
+    }
+}
+
+}  // namespace json_detail
+
+// to_json - append the JSON object text of t to out
+
+template<typename... TS>
+std::string& to_json(const named_tuple<TS...>& t, std::string& out) {
+    json_detail::write_object(out, t);
+    return out;
+}
+
+template<typename... TS>
+std::string to_json(const named_tuple<TS...>& t) {
+    std::string out;
+    return to_json(t, out);
+}
+
+// from_json - update the fields of t from the JSON object text
+
+template<typename... TS>
+void from_json(std::string_view text, named_tuple<TS...>& t) {
+    json_detail::parser p{text};
+    json_detail::read_object(p, t);
+    if (!p.at_end()) p.fail("unexpected text after the object");
+}
+
+template<typename Tuple>
+Tuple from_json(std::string_view text) {
+    Tuple t;
+    from_json(text, t);
+    return t;
+}
+
+}  // namespace nvtuple_ns
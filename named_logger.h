@@ -0,0 +1,311 @@
+#pragma once
+
+#include <named_serialize.h>
+#include <named_tuple.h>
+#include <thread_slots.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// asynchronous structured logger of named tuples:
+//
+//   nvt::logger log{std::cout};
+//   log.log(nvt::named_tuple{("id"_, 7), ("px"_, 1.5)});
+//
+// The logging thread only copies the binary encoding of the tuple
+// (named_serialize.h) into its own single producer / single consumer ring,
+// after a header with the record schema. A background thread drains the
+// rings, and writes each record to the output stream as text, with the
+// operator<< of the tuple, or as binary: the 64 bit schema id, the 32 bit
+// payload size and the payload. When a ring is full, or a string is too
+// long for the encoding, the record is dropped and counted, logging never
+// blocks. The ring of a thread that exits is reused by the next new logging
+// thread (thread_slots.h), so a logger holds as many rings as threads
+// logging at the same time.
+
+namespace nvtuple_ns {
+
+// schema_id - compile time id of a named tuple schema, a hash of the field
+// names, value type kinds and sizes, nested tuples included: int and float
+// fields of the same name have different ids.
+
+enum class type_kind : std::uint64_t {
+    boolean = 1,
+    signed_integral,
+    unsigned_integral,
+    floating_point,
+    string,
+    nested,
+    other  // enums, fixed_string and other trivially copyable values
+};
+
+template<typename T>
+constexpr type_kind type_kind_v =
+    std::is_same<T, bool>::value        ? type_kind::boolean
+    : std::is_floating_point<T>::value  ? type_kind::floating_point
+    : std::is_integral<T>::value        ? (std::is_signed<T>::value
+                                               ? type_kind::signed_integral
+                                               : type_kind::unsigned_integral)
+    : is_string_like_v<T>               ? type_kind::string
+                                        : type_kind::other;
+
+template<typename T>
+struct schema_hash {
+    static constexpr std::uint64_t value(std::uint64_t seed) noexcept {
+        return seed * 0x9e3779b97f4a7c15ULL +
+               (std::uint64_t(type_kind_v<T>) << 32) + sizeof(T);
+    }
+};
+
+template<typename... TS>
+struct schema_hash<named_tuple<TS...>> {
+    static constexpr std::uint64_t value(std::uint64_t seed) noexcept {
+        seed = seed * 0x9e3779b97f4a7c15ULL +
+               (std::uint64_t(type_kind::nested) << 32);
+        ((seed = name_hash(TS::namedtype::_name_sv,
+                           schema_hash<typename TS::type>::value(seed))),
+         ...);
+        return seed;
+    }
+};
+
+template<typename Tuple>
+constexpr std::uint64_t schema_id = schema_hash<Tuple>::value(0);
+
+// schema_info - the id of a schema and its text decoder, one static instance
+// per logged tuple type, referenced from the ring record headers.
+
+struct schema_info {
+    std::uint64_t id;
+    void (*print)(std::ostream& os, buffer_source& src);
+};
+
+namespace logger_detail {
+
+template<typename Tuple>
+void print_record(std::ostream& os, buffer_source& src) {
+    Tuple t;
+    if (deserialize(src, t))
+        os << t << '\n';
+    else
+        os << "(corrupt record)\n";
+}
+
+}  // namespace logger_detail
+
+template<typename Tuple>
+inline constexpr schema_info schema_info_v{
+    schema_id<Tuple>, &logger_detail::print_record<Tuple>};
+
+// spsc_ring - ring of variable size records, written by one thread and read
+// by another. Records are 16 byte aligned, start with a record_header, and
+// never wrap: the end of the buffer is skipped with a padding record
+// (schema nullptr).
+
+class spsc_ring {
+   public:
+    struct record_header {
+        std::uint32_t size;  // record bytes, header and alignment included
+        std::uint32_t payload;
+        const schema_info* schema;
+    };
+    static constexpr std::size_t alignment = 16;
+    static_assert(sizeof(record_header) <= alignment);
+
+    // capacity in bytes, rounded up to a power of two
+    explicit spsc_ring(std::size_t capacity)
+        : _capacity(std::bit_ceil(std::max(capacity, 4 * alignment))),
+          _data(new (std::align_val_t(alignment)) std::byte[_capacity]) {}
+
+    ~spsc_ring() {
+        ::operator delete[](_data, std::align_val_t(alignment));
+    }
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    std::size_t capacity() const noexcept { return _capacity; }
+
+    // producer: room for a record of payload bytes, nullptr when full; the
+    // record is published by commit()
+    std::byte* reserve(std::size_t payload,
+                       const schema_info* schema) noexcept {
+        const std::size_t size = (sizeof(record_header) + payload +
+                                  alignment - 1) & ~(alignment - 1);
+        const std::uint64_t head = _head.load(std::memory_order_relaxed);
+        const std::size_t pos = std::size_t(head) & (_capacity - 1);
+        const std::size_t pad = _capacity - pos < size ? _capacity - pos : 0;
+        if (head + pad + size - _tail_cache > _capacity) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            if (head + pad + size - _tail_cache > _capacity) return nullptr;
+        }
+        if (pad) {
+            new (_data + pos) record_header{std::uint32_t(pad), 0, nullptr};
+        }
+        std::byte* p = _data + ((pos + pad) & (_capacity - 1));
+        new (p) record_header{std::uint32_t(size), std::uint32_t(payload),
+                              schema};
+        _reserved = pad + size;
+        return p + sizeof(record_header);
+    }
+
+    void commit() noexcept {
+        _head.store(_head.load(std::memory_order_relaxed) + _reserved,
+                    std::memory_order_release);
+    }
+
+    // consumer: call f(header, payload) for every published record, returns
+    // the number of records
+    template<typename F>
+    std::size_t drain(F&& f) {
+        std::uint64_t tail = _tail.load(std::memory_order_relaxed);
+        const std::uint64_t head = _head.load(std::memory_order_acquire);
+        std::size_t n = 0;
+        while (tail != head) {
+            const std::byte* p = _data + (std::size_t(tail) & (_capacity - 1));
+            record_header h;
+            std::memcpy(&h, p, sizeof(h));
+            if (h.schema) {
+                f(h, p + sizeof(record_header));
+                ++n;
+            }
+            tail += h.size;
+        }
+        _tail.store(tail, std::memory_order_release);
+        return n;
+    }
+
+    bool empty() const noexcept {
+        return _head.load(std::memory_order_acquire) ==
+               _tail.load(std::memory_order_acquire);
+    }
+
+   private:
+    static constexpr std::size_t cache_line = 64;
+
+    const std::size_t _capacity;
+    std::byte* const _data;
+    alignas(cache_line) std::atomic<std::uint64_t> _head{0};
+    std::uint64_t _tail_cache{0};  // producer's copy of _tail
+    std::size_t _reserved{0};
+    alignas(cache_line) std::atomic<std::uint64_t> _tail{0};
+};
+
+// logger - per thread rings drained by a background thread to an ostream
+
+class logger {
+   public:
+    enum class output { text, binary };
+
+    explicit logger(std::ostream& os, output mode = output::text,
+                    std::size_t ring_capacity = 1 << 20)
+        : _os(&os),
+          _mode(mode),
+          _ring_capacity(ring_capacity),
+          _thread([this] { run(); }) {}
+
+    ~logger() {
+        _stop.store(true, std::memory_order_release);
+        _thread.join();
+    }
+
+    logger(const logger&) = delete;
+    logger& operator=(const logger&) = delete;
+
+    // enqueue the record, false if it was dropped, the ring of this thread
+    // being full or the tuple not encodable. Copies the tuple encoding only,
+    // formatting is done later.
+    template<typename... TS>
+    bool log(const named_tuple<TS...>& t) {
+        using tuple_type = named_tuple<TS...>;
+        spsc_ring& ring = _rings.local(_ring_capacity);
+        std::size_t n;
+        if constexpr (is_trivially_serializable_v<tuple_type>)
+            n = serialized_size_v<tuple_type>;
+        else
+            n = serialized_size(t);
+        // a record that does not fit the ring, or that cannot be encoded, is
+        // not committed: its reserved space is reused by the next record
+        std::byte* p = ring.reserve(n, &schema_info_v<tuple_type>);
+        if (!p || !serialize(t, fixed_sink{p, n})) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        ring.commit();
+        return true;
+    }
+
+    // wait until the records logged before the call are written
+    void flush() {
+        const std::uint64_t pass = _passes.load(std::memory_order_acquire);
+        // two complete passes of the background thread over all the rings
+        while (_passes.load(std::memory_order_acquire) < pass + 2)
+            std::this_thread::yield();
+        _os->flush();
+    }
+
+    std::uint64_t dropped() const noexcept {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    // the rings, at most one per thread logging at the same time
+    std::size_t ring_count() const { return _rings.size(); }
+
+   private:
+    void write(const spsc_ring::record_header& h, const std::byte* payload) {
+        if (_mode == output::text) {
+            buffer_source src{payload, h.payload};
+            h.schema->print(*_os, src);
+        } else {
+            _os->write(reinterpret_cast<const char*>(&h.schema->id),
+                       sizeof(h.schema->id));
+            _os->write(reinterpret_cast<const char*>(&h.payload),
+                       sizeof(h.payload));
+            _os->write(reinterpret_cast<const char*>(payload), h.payload);
+        }
+    }
+
+    std::size_t drain() {
+        // drained without the lock, rings are only destroyed with the logger
+        std::vector<spsc_ring*> rings;
+        _rings.for_each([&rings](spsc_ring& r) { rings.push_back(&r); });
+        std::size_t n = 0;
+        for (auto* r : rings)
+            n += r->drain([this](const auto& h, const std::byte* payload) {
+                write(h, payload);
+            });
+        return n;
+    }
+
+    void run() {
+        while (!_stop.load(std::memory_order_acquire)) {
+            const std::size_t n = drain();
+            _passes.fetch_add(1, std::memory_order_release);
+            if (!n) std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        drain();
+        _os->flush();
+    }
+
+    std::ostream* _os;
+    output _mode;
+    std::size_t _ring_capacity;
+    thread_slots<spsc_ring> _rings;
+    std::atomic<bool> _stop{false};
+    std::atomic<std::uint64_t> _passes{0};
+    std::atomic<std::uint64_t> _dropped{0};
+    std::thread _thread;
+};
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,79 @@
+// Benchmark: latency of nvt::logger::log() on several threads logging at
+// the same time, the background thread formatting the records as text to
+// /dev/null. Each call is timed, the percentiles include the clock reads.
+
+#include <named_logger.h>
+#include <named_tuple.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using fill_t =
+    nvt::named_tuple<nvt::named_value<std::uint64_t, decltype("id"_)>,
+                     nvt::named_value<double, decltype("price"_)>,
+                     nvt::named_value<std::int64_t, decltype("qty"_)>,
+                     nvt::named_value<int, decltype("venue"_)>>;
+
+int main(int argc, char** argv) {
+    const int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    const std::size_t records =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200'000;
+
+    std::ofstream devnull("/dev/null");
+    std::vector<std::vector<double>> latencies(threads);
+    std::uint64_t dropped = 0;
+    {
+        nvt::logger log{devnull};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                auto& lat = latencies[t];
+                lat.reserve(records);
+                for (std::size_t i = 0; i < records; ++i) {
+                    fill_t f{("id"_, std::uint64_t(i)), ("price"_, 100.25),
+                             ("qty"_, std::int64_t(i % 100)), ("venue"_, t)};
+                    auto t0 = std::chrono::steady_clock::now();
+                    log.log(f);
+                    auto t1 = std::chrono::steady_clock::now();
+                    lat.push_back(
+                        std::chrono::duration<double, std::nano>(t1 - t0)
+                            .count());
+                    // a record every ~1us, the rate of a busy trading thread
+                    while (std::chrono::steady_clock::now() - t1 <
+                           std::chrono::microseconds(1)) {
+                    }
+                }
+            });
+        for (auto& w : workers) w.join();
+        log.flush();
+        dropped = log.dropped();
+    }
+
+    // cost of the two clock reads around each call
+    double clock_ns = 1e30;
+    for (int i = 0; i < 1000; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        auto t1 = std::chrono::steady_clock::now();
+        clock_ns = std::min(
+            clock_ns,
+            std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+
+    std::vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double p) {
+        return all[std::min(all.size() - 1, std::size_t(p * all.size()))];
+    };
+    std::cout << threads << " threads x " << records
+              << " records, log() ns: p50 " << pct(0.5) << ", p99 "
+              << pct(0.99) << ", p99.9 " << pct(0.999) << ", dropped "
+              << dropped << ", clock reads " << clock_ns << '\n';
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Benchmark: run time lookup of a field by name, the name_index perfect hash
+// used by visit_field() / column_index(), compared to a linear compare over
+// the names() array, for 8, 64 and 512 fields.
+
+#include <named_tuple.h>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+// field names "field_000", "field_001", ...
+template<std::size_t N>
+using field_name =
+    nvt::named_type<'f', 'i', 'e', 'l', 'd', '_', char('0' + N / 100),
+                    char('0' + N / 10 % 10), char('0' + N % 10)>;
+
+template<typename Seq>
+struct fields;
+
+template<std::size_t... I>
+struct fields<std::index_sequence<I...>> {
+    using index = nvt::name_index<field_name<I>...>;
+    static constexpr std::array<const char*, sizeof...(I)> names{
+        field_name<I>::_name...};
+};
+
+template<std::size_t N>
+int linear_find(std::string_view name) {
+    const auto& names = fields<std::make_index_sequence<N>>::names;
+    for (std::size_t i = 0; i < N; ++i)
+        if (name == names[i]) return int(i);
+    return -1;
+}
+
+template<typename F>
+double best_ns_per_lookup(std::size_t lookups, F&& f) {
+    double best = 1e30;
+    for (int rep = 0; rep < 7; ++rep) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        best = std::min(best, ns / double(lookups));
+    }
+    return best;
+}
+
+template<std::size_t N>
+void run(std::size_t lookups) {
+    using index = typename fields<std::make_index_sequence<N>>::index;
+
+    // the names to look up, as run time strings, in a random order, with one
+    // in eight names not a field
+    std::vector<std::string> keys;
+    std::uint64_t seed = 88172645463325252ULL;
+    for (std::size_t i = 0; i < 4096; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        const std::size_t f = seed % N;
+        std::string key = fields<std::make_index_sequence<N>>::names[f];
+        if (seed % 8 == 0) key.back() = 'x';
+        keys.push_back(key);
+    }
+    std::vector<std::string_view> views(keys.begin(), keys.end());
+
+    volatile long sink = 0;
+    double linear_ns = best_ns_per_lookup(lookups, [&] {
+        long sum = 0;
+        for (std::size_t i = 0; i < lookups; ++i)
+            sum += linear_find<N>(views[i & 4095]);
+        sink = sum;
+    });
+    double hash_ns = best_ns_per_lookup(lookups, [&] {
+        long sum = 0;
+        for (std::size_t i = 0; i < lookups; ++i)
+            sum += index::find(views[i & 4095]);
+        sink = sum;
+    });
+    std::cout << N << " fields: linear " << linear_ns << " ns, name_index "
+              << hash_ns << " ns, speedup x" << linear_ns / hash_ns << '\n';
+}
+
+int main(int argc, char** argv) {
+    const std::size_t lookups =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    run<8>(lookups);
+    run<64>(lookups);
+    run<512>(lookups);
+    return 0;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <named_tuple.h>
+#include <thread_slots.h>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+#include <type_traits>
+
+// metrics - counters and histograms declared as one named schema, updated on
+// hot paths without sharing cache lines between threads:
+//
+//   using pipeline_t = nvt::named_tuple<
+//       nvt::named_value<uint64_t, decltype("msgs_in"_)>,
+//       nvt::named_value<nvt::histogram, decltype("latency_ns"_)>>;
+//   nvt::metrics<pipeline_t> m;
+//   m.add<"msgs_in"_>();                  // hot path
+//   m.record<"latency_ns"_>(ns);
+//   std::cout << m.collect() << '\n';     // a pipeline_t, summed
+//
+// Every thread updates its own cache line aligned shard, with relaxed
+// loads and stores (no locked instruction, the shard has a single writer).
+// collect() sums the shards of all the threads, past and present: the shard
+// of a thread that exits keeps its counts and is reused by the next new
+// thread (thread_slots.h).
+
+namespace nvtuple_ns {
+
+// histogram - counts of values in power of two buckets, bucket i holds the
+// values of bit width i: 0, 1, 2-3, 4-7, ...
+
+class histogram {
+   public:
+    static constexpr std::size_t bucket_count = 65;
+
+    static constexpr std::size_t bucket_of(std::uint64_t v) noexcept {
+        return std::size_t(std::bit_width(v));
+    }
+    // the largest value of bucket i
+    static constexpr std::uint64_t bucket_max(std::size_t i) noexcept {
+        return i >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << i) - 1;
+    }
+
+    void record(std::uint64_t v) noexcept {
+        ++_buckets[bucket_of(v)];
+        ++_count;
+        _sum += v;
+    }
+
+    histogram& operator+=(const histogram& h) noexcept {
+        for (std::size_t i = 0; i < bucket_count; ++i)
+            _buckets[i] += h._buckets[i];
+        _count += h._count;
+        _sum += h._sum;
+        return *this;
+    }
+
+    std::uint64_t count() const noexcept { return _count; }
+    std::uint64_t sum() const noexcept { return _sum; }
+    std::uint64_t bucket(std::size_t i) const noexcept { return _buckets[i]; }
+
+    // upper bound of the p quantile, p in [0, 1]: the largest value of the
+    // bucket holding it
+    std::uint64_t percentile(double p) const noexcept {
+        if (!_count) return 0;
+        const auto rank = std::uint64_t(p * double(_count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i)
+            if ((seen += _buckets[i]) >= rank) return bucket_max(i);
+        return bucket_max(bucket_count - 1);
+    }
+
+    // per thread shard of a histogram, single writer
+    class shard {
+       public:
+        void record(std::uint64_t v) noexcept {
+            bump(_buckets[bucket_of(v)], 1);
+            bump(_count, 1);
+            bump(_sum, v);
+        }
+        void add_to(histogram& h) const noexcept {
+            for (std::size_t i = 0; i < bucket_count; ++i)
+                h._buckets[i] += _buckets[i].load(std::memory_order_relaxed);
+            h._count += _count.load(std::memory_order_relaxed);
+            h._sum += _sum.load(std::memory_order_relaxed);
+        }
+
+       private:
+        static void bump(std::atomic<std::uint64_t>& a,
+                         std::uint64_t v) noexcept {
+            a.store(a.load(std::memory_order_relaxed) + v,
+                    std::memory_order_relaxed);
+        }
+        std::array<std::atomic<std::uint64_t>, bucket_count> _buckets{};
+        std::atomic<std::uint64_t> _count{0};
+        std::atomic<std::uint64_t> _sum{0};
+    };
+
+    // found by ADL when printed as a named_value of a tuple
+    friend std::ostream& operator<<(std::ostream& os, const histogram& h) {
+        os << "(count: " << h.count() << ", sum: " << h.sum()
+           << ", p50: " << h.percentile(0.5) << ", p99: " << h.percentile(0.99)
+           << ", max: " << h.percentile(1.0) << ")";
+        return os;
+    }
+
+   private:
+    std::array<std::uint64_t, bucket_count> _buckets{};
+    std::uint64_t _count{0};
+    std::uint64_t _sum{0};
+};
+
+// metric_traits<VT> - the shard storage of a metric value type, how it is
+// updated and summed
+
+template<typename VT>
+struct metric_traits {
+    static_assert(std::is_arithmetic<VT>::value,
+                  "metrics fields are arithmetic counters or histograms");
+    using storage = std::atomic<VT>;
+
+    static void add(storage& s, VT v) noexcept {
+        s.store(s.load(std::memory_order_relaxed) + v,
+                std::memory_order_relaxed);
+    }
+    static void add_to(const storage& s, VT& total) noexcept {
+        total += s.load(std::memory_order_relaxed);
+    }
+};
+
+template<>
+struct metric_traits<histogram> {
+    using storage = histogram::shard;
+
+    static void add(storage& s, std::uint64_t v) noexcept { s.record(v); }
+    static void add_to(const storage& s, histogram& total) noexcept {
+        s.add_to(total);
+    }
+};
+
+template<typename Schema>
+class metrics;
+
+template<typename... TS>
+class metrics<named_tuple<TS...>> {
+   public:
+    using tuple_type = named_tuple<TS...>;
+
+    static constexpr std::size_t cache_line = 64;
+
+    metrics() = default;
+
+    metrics(const metrics&) = delete;
+    metrics& operator=(const metrics&) = delete;
+
+    // add v to a counter, or record v in a histogram, of this thread's shard
+    template<auto N, typename V = int>
+    void add(V v = 1) {
+        using NT = typename decltype(N)::type;
+        constexpr auto i = tuple_type::template get_index<NT>();
+        using VT = typename std::tuple_element_t<i, std::tuple<TS...>>::type;
+        metric_traits<VT>::add(std::get<i>(_shards.local().fields), v);
+    }
+
+    template<auto N, typename V>
+    void record(V v) {
+        add<N>(v);
+    }
+
+    // the sum of all the shards, as a named tuple of the schema
+    tuple_type collect() const {
+        tuple_type total;
+        _shards.for_each([&total](const shard& s) {
+            (..., metric_traits<typename TS::type>::add_to(
+                      std::get<tuple_type::template get_index<
+                          typename TS::namedtype>()>(s.fields),
+                      total[typename TS::namedtype{}].get()));
+        });
+        return total;
+    }
+
+    // the shards, at most one per thread updating at the same time
+    std::size_t shard_count() const { return _shards.size(); }
+
+   private:
+    struct alignas(cache_line) shard {
+        std::tuple<typename metric_traits<typename TS::type>::storage...>
+            fields{};
+    };
+
+    thread_slots<shard> _shards;
+};
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+// named_overlay - named access, in place, to a packed binary record in a raw
+// byte buffer (e.g. a wire message), using the same named_value<> schema as a
+// named_tuple:
+//
+//   nvt::named_overlay<named_value<uint32_t, decltype("seq"_)>, ...> m{buf};
+//   uint32_t seq = m["seq"_];
+//   m["seq"_] = seq + 1;
+//
+// Fields are packed without padding in declaration order, their offsets are
+// computed at compile time from sizeof() of the value types. A field declared
+// with NVT_FIELD_ENDIAN("seq"_, std::endian::big) is converted from/to that
+// byte order on every access.
+
+namespace nvtuple_ns {
+
+template<typename FN>  // decltype("abc"_)
+class named_value_endian {
+   public:
+    constexpr const static std::endian value{std::endian::native};
+};
+
+template<typename VT>
+constexpr VT byteswap_value(VT v) noexcept {
+    static_assert(std::is_arithmetic<VT>::value || std::is_enum<VT>::value,
+                  "byte order conversion requires an arithmetic/enum field");
+    auto bytes = std::bit_cast<std::array<std::byte, sizeof(VT)>>(v);
+    for (std::size_t i = 0; i < sizeof(VT) / 2; ++i)
+        std::swap(bytes[i], bytes[sizeof(VT) - 1 - i]);
+    return std::bit_cast<VT>(bytes);
+}
+
+// wire_ref - reference to a field of type VT at address p of a packed
+// buffer. Reads and writes go through memcpy, so the field needs no
+// alignment.
+
+template<typename VT, typename NT, typename Byte>
+class wire_ref {
+   public:
+    static constexpr inline const char* get_value_name() { return NT::_name; }
+    using type = VT;
+    using namedtype = typename NT::type;
+    constexpr static inline bool is_a_named_value() { return true; }
+    constexpr static std::endian byte_order =
+        named_value_endian<namedtype>::value;
+
+    explicit wire_ref(Byte* p) noexcept : _p(p) {}
+    wire_ref(const wire_ref&) noexcept = default;
+
+    VT get() const noexcept {
+        VT v;
+        std::memcpy(&v, _p, sizeof(VT));
+        if constexpr (byte_order != std::endian::native) v = byteswap_value(v);
+        return v;
+    }
+    operator VT() const noexcept { return get(); }
+
+    const wire_ref& operator=(const VT& value) const noexcept {
+        static_assert(!std::is_const<Byte>::value,
+                      "assignment to a field of a read only overlay");
+        VT v = value;
+        if constexpr (byte_order != std::endian::native) v = byteswap_value(v);
+        std::memcpy(_p, &v, sizeof(VT));
+        return *this;
+    }
+    const wire_ref& operator=(const wire_ref& o) const noexcept {
+        return *this = o.get();
+    }
+
+   private:
+    Byte* _p;
+};
+
+template<typename Byte, typename... TS>
+class basic_named_overlay {
+   public:
+    using tuple_type = named_tuple<TS...>;
+
+    static_assert((... && std::is_trivially_copyable<typename TS::type>::value),
+                  "named_overlay fields must be trivially copyable");
+
+    static constexpr std::array<std::size_t, sizeof...(TS) + 1> offsets() {
+        std::array<std::size_t, sizeof...(TS) + 1> offs{};
+        const std::size_t sizes[]{sizeof(typename TS::type)...};
+        for (std::size_t i = 0; i < sizeof...(TS); ++i)
+            offs[i + 1] = offs[i] + sizes[i];
+        return offs;
+    }
+
+    // size in bytes of the packed record
+    static constexpr std::size_t wire_size = offsets()[sizeof...(TS)];
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            TS::get_value_name()...};
+    }
+
+    explicit basic_named_overlay(Byte* data) noexcept : _data(data) {}
+
+    Byte* data() const noexcept { return _data; }
+    static constexpr std::size_t size() noexcept { return wire_size; }
+
+    template<typename T>
+    auto get() const noexcept {
+        constexpr auto i = get_index<T>();
+        using NV = std::tuple_element_t<i, std::tuple<TS...>>;
+        return wire_ref<typename NV::type, typename NV::namedtype, Byte>{
+            _data + offsets()[i]};
+    }
+
+    template<typename T>
+    auto operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    template<typename F>
+    const basic_named_overlay& foreach (F&& f) const {
+        (..., f(get<typename TS::namedtype>()));
+        return *this;
+    }
+
+    // copy of the record as a named_tuple of the same schema
+    tuple_type to_tuple() const {
+        tuple_type t;
+        (..., (t[typename TS::namedtype{}] =
+                   get<typename TS::namedtype>().get()));
+        return t;
+    }
+
+    // write the fields of a named tuple, only fields present in the source
+    // are updated, the same as the named_tuple operator<< update.
+    template<typename... ST>
+    const basic_named_overlay& store(const named_tuple<ST...>& src) const {
+        (..., (get<typename ST::namedtype>() =
+                   src[typename ST::namedtype{}].get()));
+        return *this;
+    }
+
+   private:
+    Byte* _data;
+};
+
+template<typename... TS>
+using named_overlay = basic_named_overlay<std::byte, TS...>;
+
+template<typename... TS>
+using const_named_overlay = basic_named_overlay<const std::byte, TS...>;
+
+// overlay_for<named_tuple<TS...>>::type is named_overlay<TS...>
+
+template<typename T>
+struct overlay_for;
+
+template<typename... TS>
+struct overlay_for<named_tuple<TS...>> {
+    using type = named_overlay<TS...>;
+    using const_type = const_named_overlay<TS...>;
+};
+
+template<typename T>
+using overlay_for_t = typename overlay_for<T>::type;
+
+}  // namespace nvtuple_ns
+
+template<typename VT, typename NT, typename Byte>
+inline std::ostream& operator<<(std::ostream& os,
+                                const nvtuple_ns::wire_ref<VT, NT, Byte>& r) {
+    os << r.get_value_name() << ": " << r.get();
+    return os;
+}
+
+template<typename Byte, typename... TS>
+inline std::ostream& operator<<(
+    std::ostream& os, const nvtuple_ns::basic_named_overlay<Byte, TS...>& o) {
+    return os << o.to_tuple();
+}
+
+#define NVT_FIELD_ENDIAN(F, E)                          \
+    namespace nvtuple_ns {                              \
+    template<>                                          \
+    class named_value_endian<decltype(F)> {             \
+       public:                                          \
+        constexpr const static std::endian value{E};    \
+    };                                                  \
+    }
@@ -0,0 +1,490 @@
+#pragma once
+
+#include <named_table.h>
+#include <named_tuple.h>
+
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define NVT_QUERY_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// filter / reduce kernels over named columns, for example:
+//
+//   auto r = nvt::reduce<"qty"_>(table, nvt::where<"price"_>(nvt::gt, 10.0));
+//   r.sum, r.min, r.max, r.count, r.selected(i)
+//
+// The kernel is instantiated for the value types of the two named columns and
+// is compiled for AVX-512, AVX2 and plain scalar code; the variant is picked
+// at runtime from the cpu features. The predicate constant is compared as a
+// value, not converted: a constant the key column type does not represent
+// (10.5 or 1 << 40 for an int column) is replaced by the nearest key values
+// below and above it, and the comparison adjusted to select the same rows.
+
+namespace nvtuple_ns {
+
+// comparison operators used by where<>()
+
+struct cmp_gt {
+    template<typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const noexcept {
+        return a > b;
+    }
+};
+struct cmp_ge {
+    template<typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const noexcept {
+        return a >= b;
+    }
+};
+struct cmp_lt {
+    template<typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const noexcept {
+        return a < b;
+    }
+};
+struct cmp_le {
+    template<typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const noexcept {
+        return a <= b;
+    }
+};
+struct cmp_eq {
+    template<typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const noexcept {
+        return a == b;
+    }
+};
+struct cmp_ne {
+    template<typename A, typename B>
+    constexpr bool operator()(const A& a, const B& b) const noexcept {
+        return a != b;
+    }
+};
+
+inline constexpr cmp_gt gt{};
+inline constexpr cmp_ge ge{};
+inline constexpr cmp_lt lt{};
+inline constexpr cmp_le le{};
+inline constexpr cmp_eq eq{};
+inline constexpr cmp_ne ne{};
+
+// predicate - compares the column named NT against a constant value
+
+template<typename NT, typename Op, typename V>
+struct predicate {
+    using namedtype = NT;
+    Op op;
+    V value;
+};
+
+template<auto N, typename Op, typename V>
+constexpr auto where(Op op, const V& value) noexcept {
+    return predicate<typename decltype(N)::type, Op, V>{op, value};
+}
+
+// all_rows - selects every row
+
+struct all_rows {};
+
+enum class simd_level { scalar, avx2, avx512 };
+
+inline simd_level detect_simd_level() noexcept {
+#ifdef NVT_QUERY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+#endif
+    return simd_level::scalar;
+}
+
+namespace query_detail {
+inline std::atomic<simd_level>& active_level() noexcept {
+    static std::atomic<simd_level> level{detect_simd_level()};
+    return level;
+}
+}  // namespace query_detail
+
+inline simd_level active_simd_level() noexcept {
+    return query_detail::active_level().load(std::memory_order_relaxed);
+}
+
+// select a lower simd level, used by tests and benchmarks, a level above the
+// one detected is ignored
+
+inline void force_simd_level(simd_level level) noexcept {
+    if (level > detect_simd_level()) return;
+    query_detail::active_level().store(level, std::memory_order_relaxed);
+}
+
+template<typename VT>
+using sum_type_t = typename std::conditional<
+    std::is_floating_point<VT>::value, double,
+    typename std::conditional<std::is_signed<VT>::value, std::int64_t,
+                              std::uint64_t>::type>::type;
+
+// reduce_result - selection bitmap (bit i set if row i matched) and the
+// aggregates over the selected values. min and max are VT{} if no row matched.
+
+template<typename VT>
+struct reduce_result {
+    using value_type = VT;
+    using sum_type = sum_type_t<VT>;
+
+    std::vector<std::uint64_t> selection;
+    std::size_t count{0};
+    sum_type sum{0};
+    VT min{};
+    VT max{};
+
+    bool selected(std::size_t i) const noexcept {
+        return (selection[i / 64] >> (i % 64)) & 1U;
+    }
+};
+
+namespace query_detail {
+
+constexpr std::size_t block = 64;
+constexpr std::size_t lanes = 8;
+
+struct pack_scalar {
+    std::uint64_t operator()(const std::uint8_t* sel) const noexcept {
+        std::uint64_t w = 0;
+        for (std::size_t j = 0; j < block; ++j)
+            w |= std::uint64_t(sel[j] & 1U) << j;
+        return w;
+    }
+};
+
+#ifdef NVT_QUERY_X86_SIMD
+struct pack_avx2 {
+    [[gnu::target("avx2")]] std::uint64_t operator()(
+        const std::uint8_t* sel) const noexcept {
+        auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sel));
+        auto hi =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sel + 32));
+        return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(lo))) |
+               (std::uint64_t(std::uint32_t(_mm256_movemask_epi8(hi))) << 32);
+    }
+};
+
+struct pack_avx512 {
+    [[gnu::target("avx512f,avx512bw")]] std::uint64_t operator()(
+        const std::uint8_t* sel) const noexcept {
+        return _mm512_movepi8_mask(
+            _mm512_loadu_si512(reinterpret_cast<const void*>(sel)));
+    }
+};
+#endif
+
+template<typename VT>
+struct accumulators {
+    sum_type_t<VT> sum[lanes];
+    VT min[lanes];
+    VT max[lanes];
+    std::size_t count{0};
+
+    accumulators() noexcept {
+        for (std::size_t l = 0; l < lanes; ++l) {
+            sum[l] = 0;
+            min[l] = std::numeric_limits<VT>::max();
+            max[l] = std::numeric_limits<VT>::lowest();
+        }
+    }
+
+    [[gnu::always_inline]] inline void add(std::size_t l, bool s,
+                                           VT x) noexcept {
+        // unconditional select + min/max, which the vectorizer turns into
+        // blends, rather than a conditional update of the accumulator
+        const VT xmin = s ? x : std::numeric_limits<VT>::max();
+        const VT xmax = s ? x : std::numeric_limits<VT>::lowest();
+        sum[l] += s ? sum_type_t<VT>(x) : sum_type_t<VT>(0);
+        min[l] = xmin < min[l] ? xmin : min[l];
+        max[l] = xmax > max[l] ? xmax : max[l];
+    }
+
+    void finish(reduce_result<VT>& r) const noexcept {
+        r.count = count;
+        if (!count) return;
+        r.min = min[0];
+        r.max = max[0];
+        for (std::size_t l = 0; l < lanes; ++l) {
+            r.sum += sum[l];
+            r.min = min[l] < r.min ? min[l] : r.min;
+            r.max = max[l] > r.max ? max[l] : r.max;
+        }
+    }
+};
+
+// kernel body, inlined into each of the per-isa wrappers below (flatten also
+// inlines the Pack call, which requires the wrapper's target isa). The
+// predicate is evaluated into a 0x00/0xff byte array per block of 64 rows,
+// which is packed into one bitmap word and used as the blend mask of the lane
+// accumulators.
+
+template<typename Pack, typename VT, typename KT, typename Op, typename PV>
+[[gnu::always_inline]] inline void filter_reduce_body(
+    const VT* vals, const KT* keys, std::size_t n, Op op, PV key,
+    std::uint64_t* bits, accumulators<VT>& out) noexcept {
+    accumulators<VT> acc{out};  // local copy, kept in vector registers
+    alignas(64) std::uint8_t sel[block];
+    const std::size_t full = n / block;
+    for (std::size_t b = 0; b < full; ++b) {
+        const VT* v = vals + b * block;
+        const KT* k = keys + b * block;
+        for (std::size_t j = 0; j < block; ++j)
+            sel[j] = op(k[j], key) ? 0xff : 0;
+        const std::uint64_t w = Pack{}(sel);
+        bits[b] = w;
+        acc.count += std::popcount(w);
+        for (std::size_t j = 0; j < block; j += lanes)
+            for (std::size_t l = 0; l < lanes; ++l)
+                acc.add(l, sel[j + l], v[j + l]);
+    }
+    const std::size_t rest = n - full * block;
+    if (rest) {
+        const VT* v = vals + full * block;
+        const KT* k = keys + full * block;
+        std::uint64_t w = 0;
+        for (std::size_t j = 0; j < rest; ++j) {
+            const bool s = op(k[j], key);
+            w |= std::uint64_t(s) << j;
+            acc.add(j % lanes, s, v[j]);
+        }
+        bits[full] = w;
+        acc.count += std::popcount(w);
+    }
+    out = acc;
+}
+
+struct select_all {
+    template<typename A, typename B>
+    constexpr bool operator()(const A&, const B&) const noexcept {
+        return true;
+    }
+};
+
+struct select_none {
+    template<typename A, typename B>
+    constexpr bool operator()(const A&, const B&) const noexcept {
+        return false;
+    }
+};
+
+// key_bound - the key values nearest to a predicate constant x: down, the
+// greatest key value <= x, and up, the least key value >= x. has_down is false
+// for x below every key value, has_up for x above every key value, both for a
+// NaN constant.
+
+template<typename KT>
+struct key_bound {
+    KT down{};
+    KT up{};
+    bool has_down{true};
+    bool has_up{true};
+    bool exact() const noexcept { return has_down && has_up && down == up; }
+};
+
+template<typename KT, typename V>
+key_bound<KT> make_bound(V x) noexcept {
+    using lim = std::numeric_limits<KT>;
+    key_bound<KT> b;
+    // unary + promotes bool and the character types, not taken by cmp_less
+    if constexpr (std::is_same<KT, V>::value) {
+        b.down = b.up = x;
+    } else if constexpr (std::is_integral<KT>::value &&
+                         std::is_integral<V>::value) {
+        if (std::cmp_less(+x, +lim::min())) {
+            b.has_down = false;
+            b.up = lim::min();
+        } else if (std::cmp_greater(+x, +lim::max())) {
+            b.down = lim::max();
+            b.has_up = false;
+        } else {
+            b.down = b.up = KT(x);
+        }
+    } else if constexpr (std::is_integral<KT>::value) {
+        // lim::min() is 0 or -2^digits, lim::max() + 1 is 2^digits, both
+        // exact in V
+        const V hi = std::ldexp(V(1), lim::digits);
+        if (std::isnan(x)) {
+            b.has_down = b.has_up = false;
+        } else if (x < V(lim::min())) {
+            b.has_down = false;
+            b.up = lim::min();
+        } else if (x >= hi) {
+            b.down = lim::max();
+            b.has_up = false;
+        } else {
+            b.down = KT(std::floor(x));
+            if (std::ceil(x) == hi)
+                b.has_up = false;
+            else
+                b.up = KT(std::ceil(x));
+        }
+    } else if constexpr (std::is_floating_point<V>::value) {
+        using C = std::common_type_t<KT, V>;
+        if (std::isnan(x)) {
+            b.has_down = b.has_up = false;
+        } else if (C(x) > C(lim::max())) {
+            b.down = lim::max();
+            b.up = lim::infinity();
+        } else if (C(x) < C(lim::lowest())) {
+            b.down = -lim::infinity();
+            b.up = lim::lowest();
+        } else {
+            const KT f = KT(x);
+            b.down = b.up = f;
+            if (C(f) < C(x)) b.up = std::nextafter(f, lim::infinity());
+            if (C(x) < C(f)) b.down = std::nextafter(f, -lim::infinity());
+        }
+    } else {
+        // integral constant, floating point key: compare the rounded value
+        // as an integer, exact unless rounded to 2^digits of V or above
+        const KT f = KT(x);
+        const bool above =
+            f >= std::ldexp(KT(1), std::numeric_limits<V>::digits) ||
+            std::cmp_greater(+V(f), +x);
+        b.down = b.up = f;
+        if (above)
+            b.down = std::nextafter(f, -lim::infinity());
+        else if (std::cmp_less(+V(f), +x))
+            b.up = std::nextafter(f, lim::infinity());
+    }
+    return b;
+}
+
+// the key value op compares with, select_all or select_none for a constant
+// outside the key values
+enum class bound_use { down, up, all, none };
+
+template<typename KT>
+bound_use use_bound(cmp_gt, const key_bound<KT>& b) noexcept {
+    return b.has_down ? bound_use::down
+                      : (b.has_up ? bound_use::all : bound_use::none);
+}
+template<typename KT>
+bound_use use_bound(cmp_ge, const key_bound<KT>& b) noexcept {
+    return b.has_up ? bound_use::up : bound_use::none;
+}
+template<typename KT>
+bound_use use_bound(cmp_lt, const key_bound<KT>& b) noexcept {
+    return b.has_up ? bound_use::up
+                    : (b.has_down ? bound_use::all : bound_use::none);
+}
+template<typename KT>
+bound_use use_bound(cmp_le, const key_bound<KT>& b) noexcept {
+    return b.has_down ? bound_use::down : bound_use::none;
+}
+template<typename KT>
+bound_use use_bound(cmp_eq, const key_bound<KT>& b) noexcept {
+    return b.exact() ? bound_use::down : bound_use::none;
+}
+template<typename KT>
+bound_use use_bound(cmp_ne, const key_bound<KT>& b) noexcept {
+    return b.exact() ? bound_use::down : bound_use::all;
+}
+
+template<typename VT, typename KT, typename Op, typename PV>
+void filter_reduce_scalar(const VT* vals, const KT* keys, std::size_t n, Op op,
+                          PV key, std::uint64_t* bits,
+                          accumulators<VT>& acc) noexcept {
+    filter_reduce_body<pack_scalar>(vals, keys, n, op, key, bits, acc);
+}
+
+#ifdef NVT_QUERY_X86_SIMD
+template<typename VT, typename KT, typename Op, typename PV>
+[[gnu::target("avx2"), gnu::flatten]] void filter_reduce_avx2(
+    const VT* vals, const KT* keys, std::size_t n, Op op, PV key,
+    std::uint64_t* bits, accumulators<VT>& acc) noexcept {
+    filter_reduce_body<pack_avx2>(vals, keys, n, op, key, bits, acc);
+}
+
+template<typename VT, typename KT, typename Op, typename PV>
+[[gnu::target("avx512f,avx512bw"), gnu::flatten]] void filter_reduce_avx512(
+    const VT* vals, const KT* keys, std::size_t n, Op op, PV key,
+    std::uint64_t* bits, accumulators<VT>& acc) noexcept {
+    filter_reduce_body<pack_avx512>(vals, keys, n, op, key, bits, acc);
+}
+#endif
+
+template<typename VT, typename KT, typename Op, typename PV>
+reduce_result<VT> filter_reduce(const VT* vals, const KT* keys, std::size_t n,
+                                Op op, PV key) {
+    static_assert(std::is_arithmetic<VT>::value &&
+                      !std::is_same<VT, bool>::value,
+                  "reduce requires a numeric named column");
+    reduce_result<VT> r;
+    r.selection.resize((n + block - 1) / block);
+    accumulators<VT> acc;
+    switch (active_simd_level()) {
+#ifdef NVT_QUERY_X86_SIMD
+        case simd_level::avx512:
+            filter_reduce_avx512(vals, keys, n, op, key, r.selection.data(),
+                                 acc);
+            break;
+        case simd_level::avx2:
+            filter_reduce_avx2(vals, keys, n, op, key, r.selection.data(),
+                               acc);
+            break;
+#endif
+        default:
+            filter_reduce_scalar(vals, keys, n, op, key, r.selection.data(),
+                                 acc);
+            break;
+    }
+    acc.finish(r);
+    return r;
+}
+
+}  // namespace query_detail
+
+// reduce<"qty"_>(table, where<"price"_>(gt, x)) - aggregates of column "qty"
+// over the rows where column "price" > x. Table is any columnar container
+// whose operator[] returns a contiguous span per name, e.g. named_table.
+
+template<auto N, typename Table, typename NT, typename Op, typename V>
+auto reduce(const Table& table, const predicate<NT, Op, V>& pred) {
+    const auto vals = table[typename decltype(N)::type{}];
+    const auto keys = table[NT{}];
+    using KT = std::remove_const_t<typename decltype(keys)::element_type>;
+    static_assert(std::is_arithmetic<KT>::value && std::is_arithmetic<V>::value,
+                  "where requires a numeric named column and constant");
+    const auto b = query_detail::make_bound<KT>(pred.value);
+    switch (query_detail::use_bound(pred.op, b)) {
+        case query_detail::bound_use::down:
+            return query_detail::filter_reduce(vals.data(), keys.data(),
+                                               vals.size(), pred.op, b.down);
+        case query_detail::bound_use::up:
+            return query_detail::filter_reduce(vals.data(), keys.data(),
+                                               vals.size(), pred.op, b.up);
+        case query_detail::bound_use::all:
+            return query_detail::filter_reduce(vals.data(), keys.data(),
+                                               vals.size(),
+                                               query_detail::select_all{}, 0);
+        default:
+            return query_detail::filter_reduce(vals.data(), keys.data(),
+                                               vals.size(),
+                                               query_detail::select_none{}, 0);
+    }
+}
+
+template<auto N, typename Table>
+auto reduce(const Table& table, all_rows = {}) {
+    const auto vals = table[typename decltype(N)::type{}];
+    return query_detail::filter_reduce(vals.data(), vals.data(), vals.size(),
+                                       query_detail::select_all{}, 0);
+}
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,81 @@
+// Benchmark: "sum qty where price > x" over a named_table with the
+// nvt::reduce<> kernels, compared to foreach over a vector<named_tuple>.
+
+#include <named_query.h>
+#include <named_table.h>
+#include <named_tuple.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using order_t =
+    nvt::named_tuple<nvt::named_value<std::uint64_t, decltype("id"_)>,
+                     nvt::named_value<double, decltype("price"_)>,
+                     nvt::named_value<std::int64_t, decltype("qty"_)>,
+                     nvt::named_value<int, decltype("venue"_)>,
+                     nvt::named_value<double, decltype("fee"_)>>;
+
+template<typename F>
+double best_ns_per_row(std::size_t rows, F&& f) {
+    double best = 1e30;
+    for (int rep = 0; rep < 7; ++rep) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        best = std::min(best, ns / double(rows));
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10)
+                                      : 10'000'000;
+    const double limit = 500.0;
+
+    std::vector<order_t> vec;
+    vec.reserve(rows);
+    nvt::table_for_t<order_t> table;
+    table.reserve(rows);
+    std::uint64_t seed = 88172645463325252ULL;
+    for (std::size_t i = 0; i < rows; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        order_t o{("id"_, i), ("price"_, double(seed % 1000)),
+                  ("qty"_, std::int64_t(seed % 100)), ("venue"_, int(seed % 7)),
+                  ("fee"_, 0.01)};
+        vec.push_back(o);
+        table.push_back(o);
+    }
+
+    volatile std::int64_t sink = 0;
+    double foreach_ns = best_ns_per_row(rows, [&] {
+        std::int64_t sum = 0;
+        for (auto& o : vec)
+            if (o["price"_].get() > limit) sum += o["qty"_].get();
+        sink = sum;
+    });
+    std::cout << "vector<named_tuple> foreach: " << foreach_ns << " ns/row\n";
+
+    for (auto level : {nvt::simd_level::scalar, nvt::simd_level::avx2,
+                       nvt::simd_level::avx512}) {
+        if (level > nvt::detect_simd_level()) continue;
+        nvt::force_simd_level(level);
+        double ns = best_ns_per_row(rows, [&] {
+            auto r = nvt::reduce<"qty"_>(table,
+                                         nvt::where<"price"_>(nvt::gt, limit));
+            sink = r.sum;
+        });
+        const char* name = level == nvt::simd_level::avx512 ? "avx512"
+                           : level == nvt::simd_level::avx2 ? "avx2"
+                                                            : "scalar";
+        std::cout << "named_table reduce (" << name << "): " << ns
+                  << " ns/row, speedup x" << foreach_ns / ns << '\n';
+    }
+    return 0;
+}
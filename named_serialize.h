@@ -0,0 +1,291 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// compact binary encoding of named tuples:
+//
+//   std::vector<std::byte> buf;
+//   nvt::serialize(t, nvt::vector_sink{buf});
+//   auto t2 = nvt::deserialize<decltype(t)>(nvt::buffer_source{buf});
+//
+// Fields are written in declaration order without names or padding, in the
+// native byte order. A trivially copyable field (fixed_string<N> included) is
+// written as its bytes, a std::string, std::string_view or C string as a
+// uint32_t length followed by the characters, and a nested named_tuple as its
+// fields; serialize() fails for a string of 4 GiB or more. A std::string_view
+// field is read as a view of the source buffer. A schema with only trivially
+// copyable fields (is_trivially_serializable) has a compile time size, and its
+// encoding is the named_overlay<> layout of the same schema.
+//
+// A sink provides std::byte* reserve(std::size_t n), returning room for n
+// bytes or nullptr. serialize() computes the record size first and reserves
+// it once, so fields are copied without per-field checks or allocations.
+
+namespace nvtuple_ns {
+
+// fixed_sink - caller provided buffer of fixed size
+
+class fixed_sink {
+   public:
+    fixed_sink(std::byte* data, std::size_t size) noexcept
+        : _begin(data), _cur(data), _end(data + size) {}
+    explicit fixed_sink(std::span<std::byte> buf) noexcept
+        : fixed_sink(buf.data(), buf.size()) {}
+
+    std::byte* reserve(std::size_t n) noexcept {
+        if (std::size_t(_end - _cur) < n) return nullptr;
+        std::byte* p = _cur;
+        _cur += n;
+        return p;
+    }
+
+    std::size_t size() const noexcept { return std::size_t(_cur - _begin); }
+    std::span<std::byte> written() const noexcept { return {_begin, size()}; }
+
+   private:
+    std::byte* _begin;
+    std::byte* _cur;
+    std::byte* _end;
+};
+
+// vector_sink - appends to a caller owned std::vector, which grows as needed
+// and can be reused (clear() keeps its capacity) across records.
+
+class vector_sink {
+   public:
+    explicit vector_sink(std::vector<std::byte>& buf) noexcept : _buf(&buf) {}
+
+    std::byte* reserve(std::size_t n) {
+        const std::size_t at = _buf->size();
+        _buf->resize(at + n);
+        return _buf->data() + at;
+    }
+
+    std::size_t size() const noexcept { return _buf->size(); }
+
+   private:
+    std::vector<std::byte>* _buf;
+};
+
+// buffer_source - reads encoded records from a byte range
+
+class buffer_source {
+   public:
+    buffer_source(const std::byte* data, std::size_t size) noexcept
+        : _cur(data), _end(data + size) {}
+    explicit buffer_source(std::span<const std::byte> buf) noexcept
+        : buffer_source(buf.data(), buf.size()) {}
+
+    const std::byte* take(std::size_t n) noexcept {
+        if (remaining() < n) return nullptr;
+        const std::byte* p = _cur;
+        _cur += n;
+        return p;
+    }
+
+    std::size_t remaining() const noexcept { return std::size_t(_end - _cur); }
+
+   private:
+    const std::byte* _cur;
+    const std::byte* _end;
+};
+
+template<typename T>
+struct is_trivially_serializable
+    : std::bool_constant<std::is_trivially_copyable<T>::value &&
+                         !std::is_pointer<T>::value> {};
+
+// a string_view is encoded as its characters, not as the pointer and size
+template<>
+struct is_trivially_serializable<std::string_view> : std::false_type {};
+
+template<typename... TS>
+struct is_trivially_serializable<named_tuple<TS...>>
+    : std::bool_constant<(
+          ... && is_trivially_serializable<typename TS::type>::value)> {};
+
+template<typename T>
+constexpr bool is_trivially_serializable_v =
+    is_trivially_serializable<T>::value;
+
+namespace serial_detail {
+
+template<typename T>
+struct fixed_size {
+    static constexpr std::size_t value = sizeof(T);
+};
+
+template<typename... TS>
+struct fixed_size<named_tuple<TS...>> {
+    static constexpr std::size_t value =
+        (std::size_t(0) + ... + fixed_size<typename TS::type>::value);
+};
+
+using length_type = std::uint32_t;
+
+template<typename F, typename... TS>
+void for_each_value(named_tuple<TS...>& t, F&& f) {
+    (..., f(t[typename TS::namedtype{}].get()));
+}
+
+template<typename F, typename... TS>
+void for_each_value(const named_tuple<TS...>& t, F&& f) {
+    (..., f(t[typename TS::namedtype{}].get()));
+}
+
+template<typename T>
+std::size_t size_of(const T& v) noexcept {
+    if constexpr (is_trivially_serializable<T>::value) {
+        return fixed_size<T>::value;
+    } else if constexpr (is_string_like_v<T>) {
+        return sizeof(length_type) + std::string_view(v).size();
+    } else if constexpr (is_named_tuple<T>::value) {
+        std::size_t n = 0;
+        for_each_value(v, [&n](const auto& fv) { n += size_of(fv); });
+        return n;
+    } else {
+        static_assert(is_named_tuple<T>::value,
+                      "no binary encoding for this named value type");
+        return 0;
+    }
+}
+
+// every string of v fits the length field
+template<typename T>
+bool lengths_fit(const T& v) noexcept {
+    if constexpr (is_trivially_serializable<T>::value) {
+        return true;
+    } else if constexpr (is_string_like_v<T>) {
+        return std::string_view(v).size() <=
+               std::numeric_limits<length_type>::max();
+    } else {
+        bool fit = true;
+        for_each_value(v, [&fit](const auto& fv) {
+            fit = fit && lengths_fit(fv);
+        });
+        return fit;
+    }
+}
+
+// A named tuple is written field by field, also when all its fields are
+// trivially copyable: std::tuple does not keep the declaration order in
+// memory (libstdc++ stores the last field first) and may pad between
+// fields, so the tuple bytes are not the packed wire layout. The field
+// copies have compile time sizes and offsets, and the compiler merges them.
+template<typename T>
+void write(std::byte*& p, const T& v) noexcept {
+    if constexpr (is_named_tuple<T>::value) {
+        for_each_value(v, [&p](const auto& fv) { write(p, fv); });
+    } else if constexpr (is_trivially_serializable<T>::value) {
+        std::memcpy(p, &v, sizeof(T));
+        p += sizeof(T);
+    } else {
+        const std::string_view s(v);
+        const auto len = length_type(s.size());
+        std::memcpy(p, &len, sizeof(len));
+        std::memcpy(p + sizeof(len), s.data(), len);
+        p += sizeof(len) + len;
+    }
+}
+
+// read from a range already known to hold fixed_size<T> bytes
+template<typename T>
+void read_fixed(const std::byte*& p, T& v) noexcept {
+    if constexpr (is_named_tuple<T>::value) {
+        for_each_value(v, [&p](auto& fv) { read_fixed(p, fv); });
+    } else {
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+    }
+}
+
+template<typename T>
+bool read(buffer_source& src, T& v) {
+    if constexpr (is_trivially_serializable<T>::value) {
+        const std::byte* p = src.take(fixed_size<T>::value);
+        if (!p) return false;
+        read_fixed(p, v);
+        return true;
+    } else if constexpr (is_named_tuple<T>::value) {
+        bool ok = true;
+        for_each_value(v, [&](auto& fv) { ok = ok && read(src, fv); });
+        return ok;
+    } else {
+        static_assert(!std::is_pointer<T>::value,
+                      "C string fields are written, but can not be read, "
+                      "use std::string_view");
+        length_type len;
+        const std::byte* p = src.take(sizeof(len));
+        if (!p) return false;
+        std::memcpy(&len, p, sizeof(len));
+        if (!(p = src.take(len))) return false;
+        if constexpr (std::is_same<T, std::string_view>::value)
+            v = {reinterpret_cast<const char*>(p), len};  // view of the source
+        else
+            v.assign(reinterpret_cast<const char*>(p), len);
+        return true;
+    }
+}
+
+}  // namespace serial_detail
+
+// encoded size of a record, a compile time constant for trivially
+// serializable schemas
+
+template<typename T>
+constexpr std::size_t serialized_size_v = serial_detail::fixed_size<T>::value;
+
+template<typename... TS>
+std::size_t serialized_size(const named_tuple<TS...>& t) noexcept {
+    return serial_detail::size_of(t);
+}
+
+// serialize - append the encoding of t to the sink, false if the sink has no
+// room for it or a string is too long for its uint32_t length
+
+template<typename Sink, typename... TS>
+bool serialize(const named_tuple<TS...>& t, Sink&& sink) {
+    std::size_t n;
+    if constexpr (is_trivially_serializable<named_tuple<TS...>>::value) {
+        n = serialized_size_v<named_tuple<TS...>>;
+    } else {
+        if (!serial_detail::lengths_fit(t)) return false;
+        n = serialized_size(t);
+    }
+    std::byte* p = sink.reserve(n);
+    if (!p) return false;
+    serial_detail::write(p, t);
+    return true;
+}
+
+// deserialize - decode the next record of the source into t, false if the
+// source is too short
+
+template<typename... TS>
+bool deserialize(buffer_source& src, named_tuple<TS...>& t) {
+    return serial_detail::read(src, t);
+}
+
+template<typename Tuple>
+std::optional<Tuple> deserialize(buffer_source& src) {
+    std::optional<Tuple> t{std::in_place};
+    if (!serial_detail::read(src, *t)) t.reset();
+    return t;
+}
+
+template<typename Tuple>
+std::optional<Tuple> deserialize(buffer_source&& src) {
+    return deserialize<Tuple>(src);
+}
+
+}  // namespace nvtuple_ns
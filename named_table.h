@@ -0,0 +1,355 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// named_table - columnar (structure of arrays) container of named tuples.
+// Every named value of the schema is kept in its own contiguous column, so a
+// scan over one field touches only that field's memory.
+
+namespace nvtuple_ns {
+
+// bool_vector - the column of a bool field: one bool per element, with the
+// std::vector members the table uses, as std::vector<bool> packs the bits
+// and has no data() to view the column as a std::span<bool>.
+
+class bool_vector {
+   public:
+    using value_type = bool;
+    using size_type = std::size_t;
+    using iterator = bool*;
+    using const_iterator = const bool*;
+
+    bool_vector() = default;
+    explicit bool_vector(std::size_t n) { resize(n); }
+    bool_vector(const bool_vector& o) { *this = o; }
+    bool_vector(bool_vector&& o) noexcept
+        : _data(std::move(o._data)),
+          _size(std::exchange(o._size, 0)),
+          _capacity(std::exchange(o._capacity, 0)) {}
+
+    bool_vector& operator=(const bool_vector& o) {
+        if (this != &o) {
+            _size = 0;
+            reserve(o._size);
+            std::copy_n(o.data(), o._size, data());
+            _size = o._size;
+        }
+        return *this;
+    }
+    bool_vector& operator=(bool_vector&& o) noexcept {
+        _data = std::move(o._data);
+        _size = std::exchange(o._size, 0);
+        _capacity = std::exchange(o._capacity, 0);
+        return *this;
+    }
+
+    bool* data() noexcept { return _data.get(); }
+    const bool* data() const noexcept { return _data.get(); }
+    std::size_t size() const noexcept { return _size; }
+    std::size_t capacity() const noexcept { return _capacity; }
+    bool empty() const noexcept { return _size == 0; }
+
+    bool& operator[](std::size_t i) noexcept { return _data[i]; }
+    const bool& operator[](std::size_t i) const noexcept { return _data[i]; }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + _size; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + _size; }
+
+    void reserve(std::size_t n) {
+        if (n <= _capacity) return;
+        std::unique_ptr<bool[]> p{new bool[n]};
+        std::copy_n(data(), _size, p.get());
+        _data = std::move(p);
+        _capacity = n;
+    }
+    void resize(std::size_t n, bool value = false) {
+        if (n > _capacity) reserve(std::max(n, 2 * _capacity));
+        if (n > _size) std::fill(data() + _size, data() + n, value);
+        _size = n;
+    }
+    void clear() noexcept { _size = 0; }
+
+    void push_back(bool value) {
+        if (_size == _capacity) reserve(std::max<std::size_t>(16, 2 * _size));
+        _data[_size++] = value;
+    }
+    bool& emplace_back(bool value) {
+        push_back(value);
+        return _data[_size - 1];
+    }
+    void pop_back() noexcept { --_size; }
+
+    // insert [first, last) before pos
+    template<typename It>
+    iterator insert(const_iterator pos, It first, It last) {
+        const std::size_t at = std::size_t(pos - data());
+        const std::size_t n = std::size_t(std::distance(first, last));
+        if (_size + n > _capacity) reserve(std::max(_size + n, 2 * _capacity));
+        std::copy_backward(data() + at, data() + _size, data() + _size + n);
+        std::copy(first, last, data() + at);
+        _size += n;
+        return data() + at;
+    }
+
+   private:
+    std::unique_ptr<bool[]> _data;
+    std::size_t _size{0};
+    std::size_t _capacity{0};
+};
+
+// column_vector_t<T> - the storage of a column of values of type T
+
+template<typename T>
+using column_vector_t =
+    std::conditional_t<std::is_same<T, bool>::value, bool_vector,
+                       std::vector<T>>;
+
+template<typename... TS>
+class named_table;
+
+// named_row - proxy to one row of a named_table, with the named_tuple
+// accessors: operator[], get<>(), foreach() and names(). Fields are returned
+// as named_ref<> into the table columns.
+
+template<typename Table>
+class named_row {
+   public:
+    using table_type = std::remove_const_t<Table>;
+    using tuple_type = typename table_type::tuple_type;
+
+    constexpr named_row(Table& table, std::size_t index) noexcept
+        : _table(&table), _index(index) {}
+
+    constexpr std::size_t index() const noexcept { return _index; }
+
+    static constexpr auto names() noexcept { return table_type::names(); }
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return table_type::template get_index<T>();
+    }
+
+    template<typename T>
+    constexpr decltype(auto) get() const noexcept {
+        return _table->template cell<T>(_index);
+    }
+
+    template<typename T>
+    constexpr decltype(auto) operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    template<typename F>
+    const named_row& foreach (F&& f) const {
+        _table->foreach_cell(_index, std::forward<F>(f));
+        return *this;
+    }
+
+    // copy of the row values as a named_tuple of the table schema
+    tuple_type to_tuple() const { return _table->to_tuple(_index); }
+
+   private:
+    Table* _table;
+    std::size_t _index;
+};
+
+template<typename... TS>
+class named_table {
+    static_assert(sizeof...(TS) > 0, "a named_table needs at least one column");
+
+   public:
+    using type = named_table<TS...>;
+    using tuple_type = named_tuple<TS...>;
+    using columns_type =
+        std::tuple<column_vector_t<typename TS::type>...>;
+    using row_type = named_row<named_table>;
+    using const_row_type = named_row<const named_table>;
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    template<typename T>
+    using value_type_of = typename std::tuple_element_t<
+        get_index<T>(), std::tuple<TS...>>::type;
+
+    static constexpr std::size_t column_count() noexcept {
+        return sizeof...(TS);
+    }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            TS::get_value_name()...};
+    }
+
+    // index of the column named name, or -1, for names known only at run
+    // time, using the compile time perfect hash of the column names.
+    static constexpr int column_index(std::string_view name) noexcept {
+        return tuple_type::field_index(name);
+    }
+
+    named_table() = default;
+    explicit named_table(std::size_t rows) { resize(rows); }
+
+    std::size_t size() const noexcept { return std::get<0>(_columns).size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    void reserve(std::size_t n) {
+        std::apply([n](auto&... col) { (..., col.reserve(n)); }, _columns);
+    }
+    // all the columns or none are resized: shrinking does not throw
+    void resize(std::size_t n) {
+        const std::size_t rows = size();
+        try {
+            std::apply([n](auto&... col) { (..., col.resize(n)); }, _columns);
+        } catch (...) {
+            if (n > rows)
+                std::apply([rows](auto&... col) { (..., col.resize(rows)); },
+                           _columns);
+            throw;
+        }
+    }
+    void clear() noexcept {
+        std::apply([](auto&... col) { (..., col.clear()); }, _columns);
+    }
+
+    // append a row from a named tuple with the same field names, in any
+    // order; if a column throws, the columns already appended are shrunk
+    // back and the table is unchanged
+
+    template<typename... ST>
+    void push_back(const named_tuple<ST...>& t) {
+        static_assert(sizeof...(ST) == sizeof...(TS),
+                      "push_back requires a named tuple with matching names");
+        append_row([&t]<typename NT>(auto& col) {
+            col.push_back(t[NT{}].get());
+        });
+    }
+
+    template<typename... ST>
+    void push_back(named_tuple<ST...>&& t) {
+        static_assert(sizeof...(ST) == sizeof...(TS),
+                      "push_back requires a named tuple with matching names");
+        append_row([&t]<typename NT>(auto& col) {
+            col.push_back(std::move(t[NT{}].get()));
+        });
+    }
+
+    template<typename T>
+    constexpr auto& column() noexcept {
+        return std::get<get_index<T>()>(_columns);
+    }
+
+    template<typename T>
+    constexpr const auto& column() const noexcept {
+        return std::get<get_index<T>()>(_columns);
+    }
+
+    template<typename T>
+    std::span<value_type_of<T>> operator[](T) noexcept {
+        return {column<T>().data(), size()};
+    }
+
+    template<typename T>
+    std::span<const value_type_of<T>> operator[](T) const noexcept {
+        return {column<T>().data(), size()};
+    }
+
+    row_type row(std::size_t i) noexcept { return {*this, i}; }
+    const_row_type row(std::size_t i) const noexcept { return {*this, i}; }
+
+    template<typename T>
+    auto cell(std::size_t i) noexcept {
+        using NV = std::tuple_element_t<get_index<T>(), std::tuple<TS...>>;
+        return named_ref<typename NV::type, typename NV::namedtype>{
+            column<T>()[i]};
+    }
+
+    template<typename T>
+    auto cell(std::size_t i) const noexcept {
+        using NV = std::tuple_element_t<get_index<T>(), std::tuple<TS...>>;
+        return named_ref<const typename NV::type, typename NV::namedtype>{
+            column<T>()[i]};
+    }
+
+    template<typename F>
+    void foreach_cell(std::size_t i, F&& f) {
+        (..., f(cell<typename TS::namedtype>(i)));
+    }
+
+    template<typename F>
+    void foreach_cell(std::size_t i, F&& f) const {
+        (..., f(cell<typename TS::namedtype>(i)));
+    }
+
+    tuple_type to_tuple(std::size_t i) const {
+        tuple_type t;
+        (..., (t[typename TS::namedtype{}] =
+                   column<typename TS::namedtype>()[i]));
+        return t;
+    }
+
+    columns_type& columns() noexcept { return _columns; }
+    const columns_type& columns() const noexcept { return _columns; }
+
+   private:
+    template<typename F>
+    void append_row(F&& append) {
+        std::size_t done = 0;
+        try {
+            (..., (append.template operator()<typename TS::namedtype>(
+                       column<typename TS::namedtype>()),
+                   ++done));
+        } catch (...) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (..., (I < done ? std::get<I>(_columns).pop_back() : void()));
+            }(std::index_sequence_for<TS...>{});
+            throw;
+        }
+    }
+
+    columns_type _columns;
+};
+
+// table_for<named_tuple<TS...>>::type is named_table<TS...>
+
+template<typename T>
+struct table_for;
+
+template<typename... TS>
+struct table_for<named_tuple<TS...>> {
+    using type = named_table<TS...>;
+};
+
+template<typename T>
+using table_for_t = typename table_for<T>::type;
+
+}  // namespace nvtuple_ns
+
+template<typename Table>
+inline std::ostream& operator<<(std::ostream& os,
+                                const nvtuple_ns::named_row<Table>& r) {
+    const char* sep = "(";
+    r.foreach ([&](const auto& nr) {
+        os << sep << nr;
+        sep = ", ";
+    });
+    os << ")";
+    return os;
+}
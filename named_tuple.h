@@ -5,10 +5,19 @@
 
 #pragma once
 
+#include <fixed_string.h>
+
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace nvtuple_ns {
 template<typename VT, typename NT>
@@ -27,6 +36,67 @@ class named_value_type {
     using type = void;
 };
 
+// string literal policies - the value type of a named value made from a string
+// literal, ("sym"_, "AAPL"), for a field without NVT_FIELD_TYPE. The program
+// wide policy is NVT_STRING_LITERAL_POLICY, std::string by default; define it
+// the same way in every translation unit, before including named_tuple.h.
+
+struct literal_as_string {
+    template<std::size_t N>
+    using type = std::string;
+};
+
+struct literal_as_string_view {
+    template<std::size_t N>
+    using type = std::string_view;
+};
+
+struct literal_as_fixed_string {
+    template<std::size_t N>
+    using type = fixed_string<N - 1>;
+};
+
+struct literal_as_c_str {
+    template<std::size_t N>
+    using type = const char*;
+};
+
+// std::pmr::string, for records built with a memory resource, see the
+// allocator extended constructors of named_tuple
+struct literal_as_pmr_string {
+    template<std::size_t N>
+    using type = std::pmr::string;
+};
+
+#ifndef NVT_STRING_LITERAL_POLICY
+#define NVT_STRING_LITERAL_POLICY nvtuple_ns::literal_as_string
+#endif
+
+using string_literal_policy = NVT_STRING_LITERAL_POLICY;
+
+// std::basic_string of char with any allocator, std::string or
+// std::pmr::string
+
+template<typename T>
+struct is_std_string : std::false_type {};
+
+template<typename Traits, typename Alloc>
+struct is_std_string<std::basic_string<char, Traits, Alloc>>
+    : std::true_type {};
+
+// string like value types, printed quoted by the operator<<
+
+template<typename T>
+struct is_string_like
+    : std::bool_constant<is_std_string<T>::value ||
+                         std::is_same<T, std::string_view>::value ||
+                         std::is_same<T, const char*>::value ||
+                         std::is_same<T, char*>::value ||
+                         is_fixed_string<T>::value> {};
+
+template<typename T>
+constexpr bool is_string_like_v = is_string_like<std::remove_const_t<T>>::value;
+
 template<typename VT, typename NT>
 class named_value {
    public:
@@ -49,6 +119,26 @@ class named_value {
     explicit named_value(Args... args)
         : _data(std::forward<Args...>(args)...) {}
 
+    // allocator extended constructors, the value is made by uses-allocator
+    // construction; std::uses_allocator<named_value, A> is that of VT
+    template<typename Alloc>
+    named_value(std::allocator_arg_t, const Alloc& a)
+        : _data(std::make_obj_using_allocator<VT>(a)) {}
+
+    template<typename Alloc>
+    named_value(std::allocator_arg_t, const Alloc& a, const named_value& o)
+        : _data(std::make_obj_using_allocator<VT>(a, o._data)) {}
+
+    template<typename Alloc>
+    named_value(std::allocator_arg_t, const Alloc& a, named_value&& o)
+        : _data(std::make_obj_using_allocator<VT>(a, std::move(o._data))) {}
+
+    template<typename Alloc, typename V,
+             typename = std::enable_if_t<
+                 !std::is_same<std::remove_cvref_t<V>, named_value>::value>>
+    named_value(std::allocator_arg_t, const Alloc& a, V&& v)
+        : _data(std::make_obj_using_allocator<VT>(a, std::forward<V>(v))) {}
+
     operator decltype(auto)() { return _data; }
     operator decltype(auto)() const { return _data; }
     // operator const VT&() const { return _data; }
@@ -68,6 +158,38 @@ class named_value {
     VT _data;
 };
 
+// named_ref - reference to a value of type VT stored elsewhere (a table
+// column, a wire buffer, another tuple), with the same accessors as
+// named_value. Assignment writes through to the referenced value.
+
+template<typename VT, typename NT>
+class named_ref {
+   public:
+    static constexpr inline const char* get_value_name() { return NT::_name; }
+    using type = std::remove_const_t<VT>;
+    using namedtype = typename NT::type;
+    constexpr static inline bool is_a_named_value() { return true; }
+
+    constexpr named_ref(VT& r) noexcept : _ref(&r) {}
+    constexpr named_ref(const named_ref&) noexcept = default;
+
+    operator VT&() const noexcept { return *_ref; }
+    constexpr VT& get() const noexcept { return *_ref; }
+
+    constexpr const named_ref& operator=(const named_ref& o) const {
+        *_ref = *o._ref;
+        return *this;
+    }
+    template<typename V>
+    constexpr const named_ref& operator=(V&& value) const {
+        *_ref = std::forward<V>(value);
+        return *this;
+    }
+
+   private:
+    VT* _ref;
+};
+
 // named type - creates a type for a given string, field a tuple member.
 
 template<char... C>
@@ -88,6 +210,130 @@ constexpr decltype(auto) operator+(const named_type<Ca...>&,
     return named_type<Ca..., Cb...>{};
 }
 
+// name_hash - 64 bit hash of a field name, the same at compile time and at
+// run time. The name is consumed eight bytes at a time (little endian), each
+// word is mixed with one multiply, followed by a final avalanche mix.
+
+constexpr std::uint64_t name_hash(std::string_view s,
+                                  std::uint64_t seed = 0) noexcept {
+    std::uint64_t h = (seed + s.size()) * 0x9e3779b97f4a7c15ULL;
+    std::size_t i = 0;
+    for (; i + 8 <= s.size(); i += 8) {
+        std::uint64_t w = 0;
+        for (std::size_t b = 0; b < 8; ++b)
+            w |= std::uint64_t(std::uint8_t(s[i + b])) << (8 * b);
+        h = std::rotl((h ^ w) * 0xff51afd7ed558ccdULL, 29);
+    }
+    if (i < s.size()) {
+        std::uint64_t w = 0;
+        for (std::size_t b = 0; i + b < s.size(); ++b)
+            w |= std::uint64_t(std::uint8_t(s[i + b])) << (8 * b);
+        h = std::rotl((h ^ w) * 0xff51afd7ed558ccdULL, 29);
+    }
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// name_index - compile time perfect hash over the names of named types NTs.
+// find(name) returns the position of name in NTs, or -1, with one hash of
+// the name, one table load and a single string compare.
+//
+// The table is built with hash and displace: the names are grouped into
+// buckets by the high bits of their hash, and each bucket gets a
+// displacement d, so slot = (lo + d * hi) % slots is free for all its names.
+
+template<typename... NTs>
+class name_index {
+   public:
+    static constexpr std::size_t count = sizeof...(NTs);
+    static constexpr std::array<std::string_view, count> names{
+        NTs::_name_sv...};
+
+    static constexpr int find(std::string_view name) noexcept {
+        if constexpr (count == 0) {
+            return -1;
+        } else {
+            const std::uint64_t h = name_hash(name, table.seed);
+            const int i = table.index[slot(h, table.disp[bucket(h)])];
+            return (i >= 0 && names[std::size_t(i)] == name) ? i : -1;
+        }
+    }
+
+   private:
+    static constexpr std::size_t slots = std::bit_ceil(2 * count + 1);
+    static constexpr std::size_t buckets = std::bit_ceil(count / 2 + 1);
+
+    static constexpr std::size_t bucket(std::uint64_t h) noexcept {
+        return std::size_t(h >> 40) & (buckets - 1);
+    }
+    static constexpr std::size_t slot(std::uint64_t h,
+                                      std::uint32_t d) noexcept {
+        const auto lo = std::uint32_t(h);
+        const auto hi = std::uint32_t(h >> 32) | 1U;
+        return std::size_t(lo + d * hi) & (slots - 1);
+    }
+
+    struct table_t {
+        std::uint64_t seed{0};
+        std::array<std::uint32_t, buckets> disp{};
+        std::array<int, slots> index{};
+    };
+
+    static constexpr bool try_build(table_t& t) {
+        // names grouped by bucket (counting sort), and the buckets in order
+        // of decreasing size, so the largest buckets are placed first
+        std::array<std::uint64_t, count> h{};
+        std::array<std::size_t, buckets + 1> start{};
+        for (std::size_t i = 0; i < count; ++i) {
+            h[i] = name_hash(names[i], t.seed);
+            ++start[bucket(h[i]) + 1];
+        }
+        for (std::size_t b = 0; b < buckets; ++b) start[b + 1] += start[b];
+        std::array<std::size_t, count> member{};
+        std::array<std::size_t, buckets> fill{};
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto b = bucket(h[i]);
+            member[start[b] + fill[b]++] = i;
+        }
+        std::array<std::size_t, buckets> order{};
+        std::size_t n = 0;
+        for (std::size_t size = count; size > 0; --size)
+            for (std::size_t b = 0; b < buckets; ++b)
+                if (fill[b] == size) order[n++] = b;
+
+        for (auto& s : t.index) s = -1;
+        for (std::size_t k = 0; k < n; ++k) {
+            const auto b = order[k];
+            bool placed = false;
+            for (std::uint32_t d = 0; d < slots && !placed; ++d) {
+                std::size_t m = start[b];
+                for (; m < start[b + 1]; ++m) {
+                    const auto s = slot(h[member[m]], d);
+                    if (t.index[s] >= 0) break;
+                    t.index[s] = int(member[m]);
+                }
+                placed = m == start[b + 1];
+                if (!placed)  // undo the names placed with this d
+                    while (m-- > start[b]) t.index[slot(h[member[m]], d)] = -1;
+                else
+                    t.disp[b] = d;
+            }
+            if (!placed) return false;
+        }
+        return true;
+    }
+
+    static constexpr table_t build() {
+        table_t t;
+        while (!try_build(t)) ++t.seed;
+        return t;
+    }
+
+    static constexpr table_t table = build();
+};
+
 // named tuple - hold named values, inherits from std::tuple
 //  TS the named value types
 
@@ -142,6 +388,31 @@ class named_tuple : public std::tuple<TS...> {
         (..., (get<typename CT::namedtype>() = cvt.get()));
     }
 
+    // allocator extended constructors: the fields whose value type uses the
+    // allocator (std::pmr::string, nested named tuples of such fields) are
+    // constructed with it, e.g. from a std::pmr::monotonic_buffer_resource
+    template<typename Alloc>
+    named_tuple(std::allocator_arg_t, const Alloc& a)
+        : std::tuple<TS...>(std::allocator_arg, a) {}
+
+    template<typename Alloc>
+    named_tuple(std::allocator_arg_t, const Alloc& a, const named_tuple& o)
+        : std::tuple<TS...>(std::allocator_arg, a,
+                            static_cast<const std::tuple<TS...>&>(o)) {}
+
+    template<typename Alloc>
+    named_tuple(std::allocator_arg_t, const Alloc& a, named_tuple&& o)
+        : std::tuple<TS...>(std::allocator_arg, a,
+                            static_cast<std::tuple<TS...>&&>(o)) {}
+
+    // named values by name, in any order, copied into allocator
+    // constructed fields
+    template<typename Alloc, typename... CT>
+    named_tuple(std::allocator_arg_t, const Alloc& a, const CT&... cvt)
+        : std::tuple<TS...>(std::allocator_arg, a) {
+        (..., (get<typename CT::namedtype>() = cvt.get()));
+    }
+
     template<typename>
     constexpr static int named_type_find(int) noexcept {
         return -1;
@@ -192,17 +463,77 @@ class named_tuple : public std::tuple<TS...> {
     inline std::tuple<typename TS::type...>& simple_tuple() {
         return reinterpret_cast<std::tuple<typename TS::type...>&>(*this);
     }
+
+    // Run time access by name: the index of the field named name, or -1,
+    // using the compile time perfect hash of the field names.
+
+    static constexpr int field_index(std::string_view name) noexcept {
+        return name_index<typename TS::namedtype...>::find(name);
+    }
+
+    // Call f with the named_value of the field named name, returns false if
+    // there is no such field. The field is selected by a table of one
+    // function per field, indexed by field_index(name).
+
+    template<typename F>
+    bool visit_field(std::string_view name, F&& f) {
+        return visit_field_impl(*this, name, f,
+                                std::index_sequence_for<TS...>{});
+    }
+
+    template<typename F>
+    bool visit_field(std::string_view name, F&& f) const {
+        return visit_field_impl(*this, name, f,
+                                std::index_sequence_for<TS...>{});
+    }
+
+   private:
+    template<std::size_t I, typename T, typename F>
+    static void visit_at(T& t, F& f) {
+        f(std::get<I>(t));
+    }
+
+    template<typename T, typename F, std::size_t... I>
+    static bool visit_field_impl(T& t, std::string_view name, F& f,
+                                 std::index_sequence<I...>) {
+        static constexpr void (*visitors[])(T&, F&) = {&visit_at<I, T, F>...};
+        const int i = field_index(name);
+        if (i < 0) return false;
+        visitors[i](t, f);
+        return true;
+    }
 };
 
 template<typename... TS>
 using tuple = named_tuple<TS...>;
 
+}  // namespace nvtuple_ns
+
+// uses-allocator construction: a named value uses an allocator when its value
+// type does, a named tuple when any of its fields does.
+
+template<typename VT, typename NT, typename Alloc>
+struct std::uses_allocator<nvtuple_ns::named_value<VT, NT>, Alloc>
+    : std::uses_allocator<VT, Alloc> {};
+
+template<typename... TS, typename Alloc>
+struct std::uses_allocator<nvtuple_ns::named_tuple<TS...>, Alloc>
+    : std::disjunction<std::uses_allocator<TS, Alloc>...> {};
+
+namespace nvtuple_ns {
+
+template<typename T>
+struct is_named_tuple : std::false_type {};
+
+template<typename... TS>
+struct is_named_tuple<named_tuple<TS...>> : std::true_type {};
+
 template<size_t N, char... C,
          typename RT = typename std::conditional<
              nvtuple_ns::named_value_type<nvtuple_ns::named_type<C...>>::value,
              typename nvtuple_ns::named_value_type<
                  nvtuple_ns::named_type<C...>>::type,
-             std::string>::type>
+             typename string_literal_policy::template type<N>>::type>
 constexpr decltype(auto) operator,(const nvtuple_ns::named_type<C...> fn,
                                    const char (&s)[N]) {
     return nvtuple_ns::named_value<RT, const decltype(fn)>{s};
@@ -266,7 +597,7 @@ template<class... T>
 inline std::ostream& operator<<(std::ostream& os, const std::tuple<T...>& tup);
 
 template<typename NT, typename VT>
-inline typename std::enable_if<std::is_same<VT, std::string>::value,
+inline typename std::enable_if<nvtuple_ns::is_string_like_v<VT>,
                                std::ostream&>::type
 operator<<(std::ostream& os,
            const typename nvtuple_ns::named_value<VT, NT>& nv) {
@@ -275,7 +606,7 @@ operator<<(std::ostream& os,
 }
 
 template<typename NT, typename VT>
-inline typename std::enable_if<!std::is_same<VT, std::string>::value,
+inline typename std::enable_if<!nvtuple_ns::is_string_like_v<VT>,
                                std::ostream&>::type
 operator<<(std::ostream& os,
            const typename nvtuple_ns::named_value<VT, NT>& nv) {
@@ -283,6 +614,22 @@ operator<<(std::ostream& os,
     return os;
 }
 
+template<typename NT, typename VT>
+inline typename std::enable_if<nvtuple_ns::is_string_like_v<VT>,
+                               std::ostream&>::type
+operator<<(std::ostream& os, const typename nvtuple_ns::named_ref<VT, NT>& nr) {
+    os << nr.get_value_name() << ": \"" << nr.get() << '"';
+    return os;
+}
+
+template<typename NT, typename VT>
+inline typename std::enable_if<!nvtuple_ns::is_string_like_v<VT>,
+                               std::ostream&>::type
+operator<<(std::ostream& os, const typename nvtuple_ns::named_ref<VT, NT>& nr) {
+    os << nr.get_value_name() << ": " << nr.get();
+    return os;
+}
+
 namespace nvtuple_ns {
 template<class TT, size_t... I>
 inline std::ostream& tuple_print(std::ostream& os, const TT& tup,
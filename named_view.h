@@ -0,0 +1,177 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// named_tuple_view - non owning view over a subset of the fields of a named
+// tuple, a named_row or another view:
+//
+//   auto v = nvt::project<"id"_, "px"_>(order);   // two named_ref<>
+//   v["px"_] = 10.5;                               // writes order["px"_]
+//   double notional(nvt::project_t<order_t, "px"_, "qty"_> v);
+//
+// A view holds one pointer per field, passing it by value copies no field.
+// Assignment writes through to the viewed fields, the same as named_ref.
+
+namespace nvtuple_ns {
+
+template<typename... RS>
+class named_tuple_view {
+   public:
+    using type = named_tuple_view<RS...>;
+    using tuple_type =
+        named_tuple<named_value<typename RS::type, typename RS::namedtype>...>;
+
+    constexpr named_tuple_view(RS... rs) noexcept : _refs(rs...) {}
+    constexpr named_tuple_view(const named_tuple_view&) noexcept = default;
+
+    static constexpr std::size_t size() noexcept { return sizeof...(RS); }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(RS)>{
+            RS::get_value_name()...};
+    }
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    template<typename T>
+    constexpr auto get() const noexcept {
+        return std::get<get_index<T>()>(_refs);
+    }
+
+    template<typename T>
+    constexpr auto operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    template<typename F>
+    const named_tuple_view& foreach (F&& f) const {
+        (..., f(get<typename RS::namedtype>()));
+        return *this;
+    }
+
+    // copy of the viewed values as a narrow named_tuple
+    tuple_type to_tuple() const {
+        tuple_type t;
+        (..., (t[typename RS::namedtype{}] =
+                   get<typename RS::namedtype>().get()));
+        return t;
+    }
+
+    // write through: assign the viewed fields from the fields of the same
+    // names of o, a view, a named_tuple or a named_row
+    const named_tuple_view& operator=(const named_tuple_view& o) const {
+        return assign(o);
+    }
+
+    template<typename Other>
+    const named_tuple_view& operator=(const Other& o) const {
+        return assign(o);
+    }
+
+    // compare the viewed fields with the fields of the same names of o,
+    // in the order of the view fields
+    template<typename... OS>
+    bool operator==(const named_tuple_view<OS...>& o) const {
+        return equals(o);
+    }
+
+    template<typename... TS>
+    bool operator==(const named_tuple<TS...>& o) const {
+        return equals(o);
+    }
+
+    template<typename... OS>
+    auto operator<=>(const named_tuple_view<OS...>& o) const {
+        return compare(o);
+    }
+
+    template<typename... TS>
+    auto operator<=>(const named_tuple<TS...>& o) const {
+        return compare(o);
+    }
+
+   private:
+    template<typename Other>
+    const named_tuple_view& assign(const Other& o) const {
+        (..., (get<typename RS::namedtype>() =
+                   o[typename RS::namedtype{}].get()));
+        return *this;
+    }
+
+    template<typename Other>
+    bool equals(const Other& o) const {
+        return (... && (get<typename RS::namedtype>().get() ==
+                        o[typename RS::namedtype{}].get()));
+    }
+
+    template<typename Other>
+    auto compare(const Other& o) const {
+        using result = std::common_comparison_category_t<
+            std::compare_three_way_result_t<typename RS::type>...>;
+        result r = result::equivalent;
+        (void)(... || ((r = std::compare_three_way{}(
+                            get<typename RS::namedtype>().get(),
+                            o[typename RS::namedtype{}].get())) != 0));
+        return r;
+    }
+
+    std::tuple<RS...> _refs;
+};
+
+// project<"id"_, "px"_>(src) - view of the named fields of src, a
+// named_tuple, a named_row or a named_tuple_view. A view of a const source
+// is read only.
+
+template<auto... N, typename Source>
+constexpr auto project(Source&& src) noexcept {
+    return named_tuple_view<named_ref<
+        std::remove_reference_t<decltype(src[N].get())>,
+        typename decltype(N)::type>...>{src[N].get()...};
+}
+
+// a view of a temporary tuple would dangle
+template<auto... N, typename... TS>
+void project(named_tuple<TS...>&&) = delete;
+
+template<auto... N, typename... TS>
+void project(const named_tuple<TS...>&&) = delete;
+
+// project_t<order_t, "id"_, "px"_> - the type of a view, for function
+// parameters
+
+template<typename Source, auto... N>
+using project_t = decltype(project<N...>(std::declval<Source&>()));
+
+}  // namespace nvtuple_ns
+
+template<typename... RS>
+inline std::ostream& operator<<(std::ostream& os,
+                                const nvtuple_ns::named_tuple_view<RS...>& v) {
+    const char* sep = "(";
+    v.foreach ([&](const auto& nr) {
+        os << sep << nr;
+        sep = ", ";
+    });
+    os << (sizeof...(RS) ? ")" : "()");
+    return os;
+}
+
+// update the fields of trg from the fields of a view
+template<typename... TT, typename... RS>
+inline auto& operator<<(nvtuple_ns::named_tuple<TT...>& trg,
+                        const nvtuple_ns::named_tuple_view<RS...>& src) {
+    (..., (trg[typename RS::namedtype{}] =
+               src[typename RS::namedtype{}].get()));
+    return trg;
+}
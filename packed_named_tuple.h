@@ -0,0 +1,224 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// packed_named_tuple - a named tuple whose fields are stored in the order
+// that minimizes padding, while names, access and iteration keep the
+// declared order:
+//
+//   nvt::packed_named_tuple<nvt::named_value<char, decltype("side"_)>,
+//                           nvt::named_value<double, decltype("px"_)>,
+//                           nvt::named_value<char, decltype("tif"_)>> o;
+//   o["px"_] = 10.5;                     // same as a named_tuple
+//   static_assert(decltype(o)::packed_size < decltype(o)::unpacked_size);
+//
+// The fields are sorted by decreasing alignment, then size. The storage is
+// a std::tuple of the sorted named values, or of the reverse order when the
+// std::tuple implementation lays its elements out backwards, whichever
+// sizeof() is smaller.
+
+namespace nvtuple_ns {
+
+namespace packed_detail {
+
+// field indices sorted by decreasing (alignment, size), stable
+template<typename... TS>
+constexpr std::array<std::size_t, sizeof...(TS)> by_alignment() {
+    std::array<std::size_t, sizeof...(TS)> order{};
+    const std::size_t aligns[]{alignof(TS)..., 0};
+    const std::size_t sizes[]{sizeof(TS)..., 0};
+    for (std::size_t i = 0; i < sizeof...(TS); ++i) {
+        std::size_t j = i;
+        for (; j > 0; --j) {
+            const std::size_t k = order[j - 1];
+            if (aligns[k] > aligns[i] ||
+                (aligns[k] == aligns[i] && sizes[k] >= sizes[i]))
+                break;
+            order[j] = k;
+        }
+        order[j] = i;
+    }
+    return order;
+}
+
+template<std::size_t N>
+constexpr std::array<std::size_t, N> reversed(std::array<std::size_t, N> a) {
+    for (std::size_t i = 0; i < N / 2; ++i) std::swap(a[i], a[N - 1 - i]);
+    return a;
+}
+
+template<std::size_t N>
+constexpr std::array<std::size_t, N> inverse(std::array<std::size_t, N> a) {
+    std::array<std::size_t, N> inv{};
+    for (std::size_t i = 0; i < N; ++i) inv[a[i]] = i;
+    return inv;
+}
+
+template<typename Tuple, typename Order, typename Seq>
+struct storage;
+
+template<typename Tuple, typename Order, std::size_t... J>
+struct storage<Tuple, Order, std::index_sequence<J...>> {
+    using type = std::tuple<std::tuple_element_t<Order::value[J], Tuple>...>;
+};
+
+template<auto A>
+struct order_constant {
+    static constexpr auto value = A;
+};
+
+}  // namespace packed_detail
+
+template<typename... TS>
+class packed_named_tuple {
+    using fields = std::tuple<TS...>;
+    using seq = std::index_sequence_for<TS...>;
+
+    static constexpr auto descending = packed_detail::by_alignment<TS...>();
+    static constexpr auto ascending = packed_detail::reversed(descending);
+
+    using descending_storage = typename packed_detail::storage<
+        fields, packed_detail::order_constant<descending>, seq>::type;
+    using ascending_storage = typename packed_detail::storage<
+        fields, packed_detail::order_constant<ascending>, seq>::type;
+
+    static constexpr bool use_descending =
+        sizeof(descending_storage) <= sizeof(ascending_storage);
+
+   public:
+    using type = packed_named_tuple<TS...>;
+    using tuple_type = named_tuple<TS...>;
+    using storage_type = std::conditional_t<use_descending, descending_storage,
+                                            ascending_storage>;
+
+    // storage_order()[j] is the declared index of the j-th stored field,
+    // slot()[i] the storage position of the declared field i
+    static constexpr std::array<std::size_t, sizeof...(TS)> storage_order() {
+        return use_descending ? descending : ascending;
+    }
+    static constexpr std::array<std::size_t, sizeof...(TS)> slot() {
+        return packed_detail::inverse(storage_order());
+    }
+
+    // compile time layout report
+    static constexpr std::size_t unpacked_size = sizeof(tuple_type);
+    static constexpr std::size_t packed_size = sizeof(storage_type);
+    static constexpr std::size_t saved_bytes = unpacked_size - packed_size;
+
+    constexpr packed_named_tuple() = default;
+
+    // by name, in any order, like named_tuple(const CT&...)
+    template<typename... CT>
+    constexpr packed_named_tuple(const CT&... nv) {
+        (..., (get<typename CT::namedtype>() = nv.get()));
+    }
+
+    template<typename... CT>
+    constexpr packed_named_tuple(const named_tuple<CT...>& t) {
+        (..., (get<typename CT::namedtype>() = t[typename CT::namedtype{}]));
+    }
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    static constexpr int field_index(std::string_view name) noexcept {
+        return tuple_type::field_index(name);
+    }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            TS::get_value_name()...};
+    }
+
+    template<typename T>
+    constexpr auto& get() noexcept {
+        return std::get<slot()[get_index<T>()]>(_storage);
+    }
+
+    template<typename T>
+    constexpr const auto& get() const noexcept {
+        return std::get<slot()[get_index<T>()]>(_storage);
+    }
+
+    template<typename T>
+    constexpr auto& operator[](T) noexcept {
+        return get<T>();
+    }
+
+    template<typename T>
+    constexpr const auto& operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    // f(named_value) in the declared order
+    template<typename F>
+    packed_named_tuple& foreach (F&& f) {
+        (..., f(get<typename TS::namedtype>()));
+        return *this;
+    }
+
+    template<typename F>
+    const packed_named_tuple& foreach (F&& f) const {
+        (..., f(get<typename TS::namedtype>()));
+        return *this;
+    }
+
+    tuple_type to_tuple() const {
+        tuple_type t;
+        (..., (t[typename TS::namedtype{}] = get<typename TS::namedtype>()));
+        return t;
+    }
+
+    storage_type& storage() noexcept { return _storage; }
+    const storage_type& storage() const noexcept { return _storage; }
+
+   private:
+    storage_type _storage{};
+};
+
+// packed_for<named_tuple<TS...>>::type is packed_named_tuple<TS...>
+
+template<typename T>
+struct packed_for;
+
+template<typename... TS>
+struct packed_for<named_tuple<TS...>> {
+    using type = packed_named_tuple<TS...>;
+};
+
+template<typename T>
+using packed_for_t = typename packed_for<T>::type;
+
+}  // namespace nvtuple_ns
+
+template<typename... TS>
+inline std::ostream& operator<<(
+    std::ostream& os, const nvtuple_ns::packed_named_tuple<TS...>& t) {
+    const char* sep = "";
+    os << "(";
+    t.foreach ([&](const auto& nv) {
+        os << sep << nv;
+        sep = ", ";
+    });
+    os << ")";
+    return os;
+}
+
+// update the fields of a packed tuple from a named tuple, the same as the
+// named_tuple operator<<
+template<typename... TT, typename... ST>
+inline auto& operator<<(nvtuple_ns::packed_named_tuple<TT...>& trg,
+                        const nvtuple_ns::named_tuple<ST...>& src) {
+    (..., (trg[typename ST::namedtype{}] = src[typename ST::namedtype{}]));
+    return trg;
+}
@@ -0,0 +1,54 @@
+// Benchmark: memory footprint and scan time of 4M order records, stored as
+// named_tuple (declared field order) and as packed_named_tuple (fields
+// reordered to minimize padding).
+
+#include <named_tuple.h>
+#include <packed_named_tuple.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using order_t = nvt::named_tuple<nvt::named_value<char, decltype("side"_)>,
+                                 nvt::named_value<double, decltype("px"_)>,
+                                 nvt::named_value<char, decltype("tif"_)>,
+                                 nvt::named_value<int, decltype("qty"_)>,
+                                 nvt::named_value<double, decltype("stop"_)>,
+                                 nvt::named_value<short, decltype("venue"_)>>;
+using packed_order_t = nvt::packed_for_t<order_t>;
+
+static_assert(packed_order_t::packed_size < packed_order_t::unpacked_size);
+
+template<typename Record>
+void scan(const char* label, std::size_t n) {
+    std::vector<Record> records(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        records[i]["px"_] = double(i % 1000) * 0.25;
+        records[i]["qty"_] = int(i % 100);
+    }
+    double total = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < 10; ++rep)
+        for (const auto& r : records)
+            total += r["px"_].get() * r["qty"_].get();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::cout << label << ": sizeof " << sizeof(Record) << ", "
+              << (n * sizeof(Record)) / (1024 * 1024) << " MiB, "
+              << double(ns) / double(10 * n) << " ns/record"
+              << " (total " << total << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                   : std::size_t(4) << 20;
+    std::cout << "layout: " << packed_order_t::unpacked_size << " -> "
+              << packed_order_t::packed_size << " bytes, "
+              << packed_order_t::saved_bytes << " saved per record\n";
+    scan<order_t>("named_tuple       ", n);
+    scan<packed_order_t>("packed_named_tuple", n);
+    return 0;
+}
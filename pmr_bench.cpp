@@ -0,0 +1,71 @@
+// Benchmark: bulk construction and teardown of order records with string
+// fields, std::string on the default heap compared to std::pmr::string in a
+// std::pmr::monotonic_buffer_resource arena, reset per batch.
+
+#include <named_tuple.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+template<typename String>
+using leg_t = nvt::named_tuple<nvt::named_value<String, decltype("venue"_)>,
+                               nvt::named_value<int, decltype("qty"_)>>;
+
+template<typename String>
+using order_t =
+    nvt::named_tuple<nvt::named_value<int, decltype("id"_)>,
+                     nvt::named_value<String, decltype("sym"_)>,
+                     nvt::named_value<String, decltype("account"_)>,
+                     nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<leg_t<String>, decltype("leg"_)>>;
+
+static const char* const account = "ACCOUNT-0000-0000-0000-LONG-NAME";
+static const char* const venue = "VENUE-WITH-A-NAME-LONGER-THAN-SSO";
+
+template<typename Vector>
+void fill(Vector& orders, std::size_t n) {
+    orders.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        orders.emplace_back(("id"_, int(i)), ("px"_, double(i)));
+        auto& o = orders.back();
+        o["sym"_] = "SYMBOL-NAME-PAST-THE-SSO-BUFFER";
+        o["account"_] = account;
+        o["leg"_].get()["venue"_] = venue;
+    }
+}
+
+template<typename F>
+void run(const char* label, std::size_t n, int batches, F&& batch) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < batches; ++b) batch(n);
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::cout << label << ": " << double(ns) / double(batches * n)
+              << " ns/record\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n =
+        argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const int batches = 20;
+
+    run("std::string, heap      ", n, batches, [](std::size_t count) {
+        std::vector<order_t<std::string>> orders;
+        fill(orders, count);
+    });
+
+    std::vector<std::byte> buffer(n * 512);
+    run("std::pmr::string, arena", n, batches, [&](std::size_t count) {
+        std::pmr::monotonic_buffer_resource arena{buffer.data(),
+                                                  buffer.size()};
+        std::pmr::vector<order_t<std::pmr::string>> orders(&arena);
+        fill(orders, count);
+    });
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Benchmark: one writer publishing a quote record while 1 to 32 readers take
+// snapshots, seqlock_tuple compared to a named_tuple behind a std::mutex.
+// Reports the total snapshots per second of the readers.
+
+#include <named_tuple.h>
+#include <seqlock_tuple.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+using quote_t =
+    nvt::named_tuple<nvt::named_value<double, decltype("px"_)>,
+                     nvt::named_value<int, decltype("size"_)>,
+                     nvt::named_value<std::uint64_t, decltype("ts"_)>,
+                     nvt::named_value<std::uint64_t, decltype("seq"_)>>;
+
+class mutex_quote {
+   public:
+    template<typename... NV>
+    void publish_fields(const NV&... nv) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        (_quote << ... << nv);
+    }
+    quote_t snapshot() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _quote;
+    }
+
+   private:
+    mutable std::mutex _mutex;
+    quote_t _quote;
+};
+
+template<typename Quote>
+double reads_per_second(int readers, std::chrono::milliseconds duration) {
+    Quote q;
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> reads{0};
+    std::thread writer([&] {
+        for (std::uint64_t i = 0; !done.load(std::memory_order_relaxed); ++i) {
+            q.publish_fields(("px"_, double(i)), ("size"_, int(i)),
+                             ("ts"_, i), ("seq"_, i));
+            // a quote update every ~1us
+            auto t0 = std::chrono::steady_clock::now();
+            while (std::chrono::steady_clock::now() - t0 <
+                   std::chrono::microseconds(1)) {
+            }
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r)
+        threads.emplace_back([&] {
+            std::uint64_t n = 0;
+            [[maybe_unused]] volatile std::uint64_t sink = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                sink = q.snapshot()["seq"_].get();
+                ++n;
+            }
+            reads += n;
+        });
+    std::this_thread::sleep_for(duration);
+    done = true;
+    writer.join();
+    for (auto& t : threads) t.join();
+    return double(reads.load()) /
+           std::chrono::duration<double>(duration).count();
+}
+
+int main(int argc, char** argv) {
+    const int max_readers = argc > 1 ? std::atoi(argv[1]) : 32;
+    const std::chrono::milliseconds duration{argc > 2 ? std::atoi(argv[2])
+                                                      : 200};
+    for (int readers = 1; readers <= max_readers; readers *= 2) {
+        double seq = reads_per_second<nvt::seqlock_for_t<quote_t>>(readers,
+                                                                   duration);
+        double mtx = reads_per_second<mutex_quote>(readers, duration);
+        std::cout << readers << " readers: seqlock_tuple " << seq / 1e6
+                  << " M reads/s, mutex " << mtx / 1e6 << " M reads/s, x"
+                  << seq / mtx << '\n';
+    }
+    return 0;
+}
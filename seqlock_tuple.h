@@ -0,0 +1,146 @@
+#pragma once
+
+#include <named_overlay.h>
+#include <named_tuple.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+// seqlock_tuple - a named tuple published by one writer thread and read by
+// any number of reader threads, without locks: readers never write shared
+// memory, so they do not contend with each other.
+//
+//   nvt::seqlock_tuple<...> quote;
+//   quote.publish_fields(("px"_, 10.25), ("seq"_, 8));   // writer
+//   auto q = quote.snapshot();                          // readers
+//   double px = quote.read<"px"_>();
+//
+// The fields are kept in their named_overlay packed layout, as 64 bit atomic
+// words, behind a sequence counter that is odd while the writer updates
+// them. Readers copy the words and retry when the counter changed.
+
+namespace nvtuple_ns {
+
+template<typename... TS>
+class seqlock_tuple {
+   public:
+    using tuple_type = named_tuple<TS...>;
+    using overlay_type = named_overlay<TS...>;
+
+    static constexpr std::size_t cache_line = 64;
+
+    seqlock_tuple() { store(); }
+    explicit seqlock_tuple(const tuple_type& t) : _shadow(t) { store(); }
+
+    seqlock_tuple(const seqlock_tuple&) = delete;
+    seqlock_tuple& operator=(const seqlock_tuple&) = delete;
+
+    // writer: update the fields present in t, the same as the named_tuple
+    // operator<< update, and publish the record
+    template<typename... ST>
+    void publish(const named_tuple<ST...>& t) noexcept {
+        _shadow << t;
+        store();
+    }
+
+    // writer: update the given named values and publish the record
+    template<typename... NV>
+    void publish_fields(const NV&... nv) noexcept {
+        (_shadow << ... << nv);
+        store();
+    }
+
+    // reader: a consistent copy of the record
+    tuple_type snapshot() const noexcept {
+        word_buffer buf;
+        load(buf, 0, words);
+        return const_named_overlay<TS...>{bytes(buf)}.to_tuple();
+    }
+
+    // reader: a consistent copy of one field, loads only its words
+    template<auto N>
+    auto read() const noexcept {
+        using NT = typename decltype(N)::type;
+        constexpr auto i = std::size_t(tuple_type::template get_index<NT>());
+        constexpr std::size_t first = overlay_type::offsets()[i] / word_size;
+        constexpr std::size_t last =
+            (overlay_type::offsets()[i + 1] + word_size - 1) / word_size;
+        word_buffer buf;
+        load(buf, first, last);
+        return const_named_overlay<TS...>{bytes(buf)}.template get<NT>().get();
+    }
+
+    // number of records published, changes with every publish; the initial
+    // record stored by the constructor is not counted
+    std::uint64_t version() const noexcept {
+        return _seq.load(std::memory_order_acquire) / 2 - 1;
+    }
+
+   private:
+    static constexpr std::size_t word_size = sizeof(std::uint64_t);
+    static constexpr std::size_t words =
+        (overlay_type::wire_size + word_size - 1) / word_size;
+
+    using word_buffer = std::uint64_t[words ? words : 1];
+
+    static const std::byte* bytes(const word_buffer& buf) noexcept {
+        return reinterpret_cast<const std::byte*>(buf);
+    }
+
+    void store() noexcept {
+        word_buffer buf{};
+        overlay_type{reinterpret_cast<std::byte*>(buf)}.store(_shadow);
+        const std::uint64_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t w = 0; w < words; ++w)
+            _words[w].store(buf[w], std::memory_order_relaxed);
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    void load(word_buffer& buf, std::size_t first,
+              std::size_t last) const noexcept {
+        for (;;) {
+            const std::uint64_t seq = _seq.load(std::memory_order_acquire);
+            if (seq & 1) {
+                pause();
+                continue;
+            }
+            for (std::size_t w = first; w < last; ++w)
+                buf[w] = _words[w].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_seq.load(std::memory_order_relaxed) == seq) return;
+        }
+    }
+
+    static void pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    // shared by the writer and the readers
+    alignas(cache_line) std::atomic<std::uint64_t> _seq{0};
+    std::atomic<std::uint64_t> _words[words ? words : 1];
+    // writer only, the full record the updates are applied to
+    alignas(cache_line) tuple_type _shadow{};
+};
+
+// seqlock_for<named_tuple<TS...>>::type is seqlock_tuple<TS...>
+
+template<typename T>
+struct seqlock_for;
+
+template<typename... TS>
+struct seqlock_for<named_tuple<TS...>> {
+    using type = seqlock_tuple<TS...>;
+};
+
+template<typename T>
+using seqlock_for_t = typename seqlock_for<T>::type;
+
+}  // namespace nvtuple_ns
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <field_mask.h>
+#include <named_tuple.h>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// sparse_named_tuple - a named tuple where every field is either set or not,
+// tracked by one presence bitmap next to the values instead of a
+// std::optional per field:
+//
+//   nvt::sparse_named_tuple<...> upd{("px"_, 10.5)};   // only px present
+//   upd.has<"qty"_>();                                  // false
+//   upd.set<"qty"_>(100);                               // qty present
+//   book << upd;                                        // copies px, qty
+//
+// operator[] and get<>() only read, present or not; set<>(value) assigns
+// and marks the field present, set<>() marks it and returns it for writing.
+// Values of absent fields are default constructed and kept, reset<>() only
+// clears the bit.
+
+namespace nvtuple_ns {
+
+template<typename... TS>
+class sparse_named_tuple {
+   public:
+    using type = sparse_named_tuple<TS...>;
+    using tuple_type = named_tuple<TS...>;
+    using mask_type = field_mask<sizeof...(TS)>;
+
+    constexpr sparse_named_tuple() = default;
+
+    // the given named values are present, in any order
+    template<typename... CT>
+    constexpr sparse_named_tuple(const CT&... nv) {
+        (..., set<typename CT::namedtype>(nv.get()));
+    }
+
+    // all the fields of a full tuple are present
+    explicit sparse_named_tuple(const tuple_type& t) : _values(t) {
+        for (std::size_t i = 0; i < sizeof...(TS); ++i) _present.set(i);
+    }
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    static constexpr int field_index(std::string_view name) noexcept {
+        return tuple_type::field_index(name);
+    }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            TS::get_value_name()...};
+    }
+
+    // presence by name, ("px"_ as template argument) or by named type
+
+    template<auto N>
+    constexpr bool has() const noexcept {
+        return has<typename decltype(N)::type>();
+    }
+
+    template<typename T>
+    constexpr bool has() const noexcept {
+        return _present.test(std::size_t(get_index<T>()));
+    }
+
+    template<auto N>
+    constexpr void reset() noexcept {
+        reset<typename decltype(N)::type>();
+    }
+
+    template<typename T>
+    constexpr void reset() noexcept {
+        _present.set(std::size_t(get_index<T>()), false);
+    }
+
+    // write access, marks the field present
+
+    template<auto N>
+    constexpr auto& set() noexcept {
+        return set<typename decltype(N)::type>();
+    }
+
+    template<typename T>
+    constexpr auto& set() noexcept {
+        _present.set(std::size_t(get_index<T>()));
+        return _values.template get<T>();
+    }
+
+    template<auto N, typename V>
+    constexpr auto& set(V&& v) {
+        return set<typename decltype(N)::type>(std::forward<V>(v));
+    }
+
+    template<typename T, typename V>
+    constexpr auto& set(V&& v) {
+        return set<T>() = std::forward<V>(v);
+    }
+
+    constexpr void clear() noexcept { _present.reset(); }
+
+    constexpr std::size_t count() const noexcept { return _present.count(); }
+    constexpr bool empty() const noexcept { return _present.none(); }
+    constexpr const mask_type& mask() const noexcept { return _present; }
+
+    // read access, present or not
+
+    template<typename T>
+    constexpr const auto& get() const noexcept {
+        return _values.template get<T>();
+    }
+
+    template<typename T>
+    constexpr const auto& operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    // f(named_value) for the present fields, in declared order
+    template<typename F>
+    const sparse_named_tuple& foreach_present(F&& f) const {
+        for_each_masked(_present, [&](auto i) {
+            f(std::get<decltype(i)::value>(_values));
+        });
+        return *this;
+    }
+
+    template<typename F>
+    sparse_named_tuple& foreach_present(F&& f) {
+        for_each_masked(_present, [&](auto i) {
+            f(std::get<decltype(i)::value>(_values));
+        });
+        return *this;
+    }
+
+    // all the values, absent fields with their default or last value
+    constexpr const tuple_type& values() const noexcept { return _values; }
+
+    // merge: copy the present fields of src, and mark them present
+    sparse_named_tuple& merge(const sparse_named_tuple& src) {
+        for_each_masked(src._present, [&](auto i) {
+            std::get<decltype(i)::value>(_values) =
+                std::get<decltype(i)::value>(src._values);
+        });
+        _present |= src._present;
+        return *this;
+    }
+
+   private:
+    mask_type _present{};
+    tuple_type _values{};
+};
+
+// sparse_for<named_tuple<TS...>>::type is sparse_named_tuple<TS...>
+
+template<typename T>
+struct sparse_for;
+
+template<typename... TS>
+struct sparse_for<named_tuple<TS...>> {
+    using type = sparse_named_tuple<TS...>;
+};
+
+template<typename T>
+using sparse_for_t = typename sparse_for<T>::type;
+
+}  // namespace nvtuple_ns
+
+// prints the present fields only
+template<typename... TS>
+inline std::ostream& operator<<(
+    std::ostream& os, const nvtuple_ns::sparse_named_tuple<TS...>& t) {
+    const char* sep = "";
+    os << "(";
+    t.foreach_present([&](const auto& nv) {
+        os << sep << nv;
+        sep = ", ";
+    });
+    os << ")";
+    return os;
+}
+
+// sparse merge: copy only the present fields of src
+template<typename... TS>
+inline auto& operator<<(nvtuple_ns::sparse_named_tuple<TS...>& trg,
+                        const nvtuple_ns::sparse_named_tuple<TS...>& src) {
+    return trg.merge(src);
+}
+
+template<typename... TT, typename... TS>
+inline auto& operator<<(nvtuple_ns::named_tuple<TT...>& trg,
+                        const nvtuple_ns::sparse_named_tuple<TS...>& src) {
+    src.foreach_present([&](const auto& nv) {
+        trg[typename std::remove_cvref_t<decltype(nv)>::namedtype{}] =
+            nv.get();
+    });
+    return trg;
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <named_tuple.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// split_tuple - a wide named record split into a hot block, kept inline and
+// cache line aligned, and a cold block allocated from a pool:
+//
+//   NVT_FIELD_HOT("px"_)
+//   nvt::split_tuple<nvt::hot<nvt::named_value<int, decltype("qty"_)>>,
+//                    nvt::named_value<double, decltype("px"_)>,
+//                    nvt::named_value<std::string, decltype("note"_)>> o;
+//   o["px"_] = 10.5;        // hot, inline
+//   o["note"_] = "manual";  // cold, one pointer away
+//
+// A field is hot when it is wrapped in hot<> or its name is declared with
+// NVT_FIELD_HOT(). Access by name, names(), foreach and printing keep the
+// declared order of the fields across both blocks. A scan over hot fields
+// of a vector of split_tuple touches one cache line per record.
+
+namespace nvtuple_ns {
+
+template<typename FN>  // decltype("abc"_)
+class named_value_hot {
+   public:
+    constexpr const static bool value{false};
+};
+
+// hot<NV> - marks the named value NV as a hot field of a split_tuple
+template<typename NV>
+struct hot {
+    using field = NV;
+};
+
+namespace split_detail {
+
+template<typename T>
+struct unwrap {
+    using type = T;
+    static constexpr bool hot = named_value_hot<typename T::namedtype>::value;
+};
+
+template<typename NV>
+struct unwrap<hot<NV>> {
+    using type = NV;
+    static constexpr bool hot = true;
+};
+
+template<typename T>
+using unwrap_t = typename unwrap<T>::type;
+
+template<typename T>
+struct to_named_tuple;
+
+template<typename... TS>
+struct to_named_tuple<std::tuple<TS...>> {
+    using type = named_tuple<TS...>;
+};
+
+// named_tuple of the fields of TS whose hotness is Hot, in declared order
+template<bool Hot, typename... TS>
+using select_t = typename to_named_tuple<decltype(std::tuple_cat(
+    std::declval<std::conditional_t<unwrap<TS>::hot == Hot,
+                                    std::tuple<unwrap_t<TS>>,
+                                    std::tuple<>>>()...))>::type;
+
+// block_pool - fixed size blocks carved from 64 KiB chunks, recycled
+// through a free list. The pool is never destroyed, on purpose: split_tuple
+// objects with static storage duration may free their blocks after every
+// function local static is gone. Its chunks go back to the system at exit.
+template<std::size_t Size, std::size_t Align>
+class block_pool {
+   public:
+    static block_pool& instance() {
+        static block_pool* const pool = new block_pool;
+        return *pool;
+    }
+
+    void* allocate() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free) grow();
+        node* n = _free;
+        _free = n->next;
+        return n;
+    }
+
+    void deallocate(void* p) noexcept {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free = new (p) node{_free};
+    }
+
+   private:
+    struct node {
+        node* next;
+    };
+
+    static constexpr std::size_t block_align = std::max(Align, alignof(node));
+    static constexpr std::size_t block_size =
+        (std::max(Size, sizeof(node)) + block_align - 1) & ~(block_align - 1);
+    static constexpr std::size_t chunk_blocks =
+        std::max<std::size_t>(1, (64 << 10) / block_size);
+
+    block_pool() = default;
+
+    void grow() {
+        auto* c = static_cast<std::byte*>(::operator new(
+            chunk_blocks * block_size, std::align_val_t(block_align)));
+        _chunks.push_back(c);
+        for (std::size_t i = chunk_blocks; i-- > 0;)
+            _free = new (c + i * block_size) node{_free};
+    }
+
+    std::mutex _mutex;
+    node* _free{nullptr};
+    std::vector<void*> _chunks;
+};
+
+}  // namespace split_detail
+
+template<typename... TS>
+class split_tuple {
+   public:
+    using type = split_tuple<TS...>;
+    using tuple_type = named_tuple<split_detail::unwrap_t<TS>...>;
+    using hot_type = split_detail::select_t<true, TS...>;
+    using cold_type = split_detail::select_t<false, TS...>;
+
+    static constexpr std::size_t cache_line = 64;
+    static constexpr std::size_t hot_size = sizeof(hot_type);
+    static constexpr std::size_t cold_size = sizeof(cold_type);
+    // all the fields hot: no cold block, and no pointer to it
+    static constexpr bool has_cold =
+        !std::is_same<cold_type, named_tuple<>>::value;
+
+    split_tuple() : _cold(make_cold()) {}
+
+    // by name, in any order, like named_tuple(const CT&...)
+    template<typename... CT>
+    split_tuple(const CT&... nv) : _cold(make_cold()) {
+        (..., (get<typename CT::namedtype>() = nv.get()));
+    }
+
+    template<typename... CT>
+    split_tuple(const named_tuple<CT...>& t) : _cold(make_cold()) {
+        (..., (get<typename CT::namedtype>() = t[typename CT::namedtype{}]));
+    }
+
+    split_tuple(const split_tuple& o)
+        : _hot(o._hot), _cold(make_cold(o.cold_block())) {}
+
+    // the moved from tuple keeps no cold block: its cold fields read as
+    // default values, and the first non const access to one allocates a new
+    // default block
+    split_tuple(split_tuple&& o) noexcept
+        : _hot(std::move(o._hot)), _cold(std::exchange(o._cold, cold_ptr{})) {}
+
+    split_tuple& operator=(const split_tuple& o) {
+        if (this == &o) return *this;
+        _hot = o._hot;
+        if constexpr (has_cold) {
+            if (_cold)
+                *_cold = o.cold_block();
+            else
+                _cold = make_cold(o.cold_block());
+        }
+        return *this;
+    }
+
+    split_tuple& operator=(split_tuple&& o) noexcept {
+        _hot = std::move(o._hot);
+        std::swap(_cold, o._cold);
+        return *this;
+    }
+
+    ~split_tuple() { free_cold(_cold); }
+
+    template<typename T>
+    constexpr static int get_index() noexcept {
+        return tuple_type::template get_index<T>();
+    }
+
+    static constexpr int field_index(std::string_view name) noexcept {
+        return tuple_type::field_index(name);
+    }
+
+    // true when the field named T is in the inline hot block
+    template<typename T>
+    static constexpr bool is_hot() noexcept {
+        return (... || (split_detail::unwrap<TS>::hot &&
+                        std::is_same<T, typename split_detail::unwrap_t<
+                                            TS>::namedtype>::value));
+    }
+
+    static constexpr auto names() noexcept {
+        return std::array<const char*, sizeof...(TS)>{
+            split_detail::unwrap_t<TS>::get_value_name()...};
+    }
+
+    template<typename T>
+    constexpr auto& get() noexcept(is_hot<T>()) {
+        if constexpr (is_hot<T>())
+            return _hot.template get<T>();
+        else
+            return cold_block().template get<T>();
+    }
+
+    template<typename T>
+    constexpr const auto& get() const noexcept {
+        if constexpr (is_hot<T>())
+            return _hot.template get<T>();
+        else
+            return cold_block().template get<T>();
+    }
+
+    template<typename T>
+    constexpr auto& operator[](T) noexcept(is_hot<T>()) {
+        return get<T>();
+    }
+
+    template<typename T>
+    constexpr const auto& operator[](T) const noexcept {
+        return get<T>();
+    }
+
+    // f(named_value) in the declared order
+    template<typename F>
+    split_tuple& foreach (F&& f) {
+        (..., f(get<typename split_detail::unwrap_t<TS>::namedtype>()));
+        return *this;
+    }
+
+    template<typename F>
+    const split_tuple& foreach (F&& f) const {
+        (..., f(get<typename split_detail::unwrap_t<TS>::namedtype>()));
+        return *this;
+    }
+
+    tuple_type to_tuple() const {
+        tuple_type t;
+        (..., (t[typename split_detail::unwrap_t<TS>::namedtype{}] =
+                   get<typename split_detail::unwrap_t<TS>::namedtype>()));
+        return t;
+    }
+
+    hot_type& hot_block() noexcept { return _hot; }
+    const hot_type& hot_block() const noexcept { return _hot; }
+    cold_type& cold_block() {
+        if constexpr (has_cold) {
+            if (!_cold) _cold = make_cold();
+            return *_cold;
+        } else {
+            static cold_type none;  // empty, no state to share
+            return none;
+        }
+    }
+    const cold_type& cold_block() const noexcept {
+        if constexpr (has_cold)
+            return _cold ? *_cold : default_cold();
+        else
+            return default_cold();
+    }
+
+   private:
+    using pool =
+        split_detail::block_pool<sizeof(cold_type), alignof(cold_type)>;
+
+    struct no_cold {};
+    using cold_ptr = std::conditional_t<has_cold, cold_type*, no_cold>;
+
+    template<typename... Args>
+    static cold_ptr make_cold(Args&&... args) {
+        if constexpr (has_cold) {
+            void* p = pool::instance().allocate();
+            try {
+                return new (p) cold_type(std::forward<Args>(args)...);
+            } catch (...) {
+                pool::instance().deallocate(p);
+                throw;
+            }
+        } else {
+            return {};
+        }
+    }
+
+    // the cold fields of a moved from tuple
+    static const cold_type& default_cold() noexcept {
+        static const cold_type c{};
+        return c;
+    }
+
+    static void free_cold(cold_type* c) noexcept {
+        if (!c) return;
+        c->~cold_type();
+        pool::instance().deallocate(c);
+    }
+    static void free_cold(no_cold) noexcept {}
+
+    alignas(cache_line) hot_type _hot{};
+    [[no_unique_address]] cold_ptr _cold;
+};
+
+// split_for<named_tuple<TS...>>::type is split_tuple<TS...>, the fields
+// declared with NVT_FIELD_HOT() are hot
+
+template<typename T>
+struct split_for;
+
+template<typename... TS>
+struct split_for<named_tuple<TS...>> {
+    using type = split_tuple<TS...>;
+};
+
+template<typename T>
+using split_for_t = typename split_for<T>::type;
+
+}  // namespace nvtuple_ns
+
+template<typename... TS>
+inline std::ostream& operator<<(std::ostream& os,
+                                const nvtuple_ns::split_tuple<TS...>& t) {
+    const char* sep = "";
+    os << "(";
+    t.foreach ([&](const auto& nv) {
+        os << sep << nv;
+        sep = ", ";
+    });
+    os << ")";
+    return os;
+}
+
+// update the fields of a split tuple from a named tuple, the same as the
+// named_tuple operator<<
+template<typename... TT, typename... ST>
+inline auto& operator<<(nvtuple_ns::split_tuple<TT...>& trg,
+                        const nvtuple_ns::named_tuple<ST...>& src) {
+    (..., (trg[typename ST::namedtype{}] = src[typename ST::namedtype{}]));
+    return trg;
+}
+
+#define NVT_FIELD_HOT(F)                         \
+    namespace nvtuple_ns {                       \
+    template<>                                   \
+    class named_value_hot<decltype(F)> {         \
+       public:                                   \
+        constexpr const static bool value{true}; \
+    };                                           \
+    }
@@ -0,0 +1,120 @@
+// Benchmark: scan of the 6 hot fields of a 60 field order record, over a
+// vector of records, stored as named_tuple and as split_tuple (hot fields in
+// an inline cache line, cold fields in a pooled block).
+// Reports ns per record and the bytes per record touched by the scan.
+
+#include <named_tuple.h>
+#include <split_tuple.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace nvt = nvtuple_ns;
+
+NVT_FIELD_HOT("px"_)
+NVT_FIELD_HOT("qty"_)
+NVT_FIELD_HOT("side"_)
+NVT_FIELD_HOT("id"_)
+NVT_FIELD_HOT("state"_)
+NVT_FIELD_HOT("filled"_)
+
+using order_t = nvt::named_tuple<
+    nvt::named_value<double, decltype("c00"_)>,
+    nvt::named_value<std::uint64_t, decltype("c01"_)>,
+    nvt::named_value<int, decltype("c02"_)>,
+    nvt::named_value<double, decltype("c03"_)>,
+    nvt::named_value<double, decltype("c04"_)>,
+    nvt::named_value<std::uint64_t, decltype("c05"_)>,
+    nvt::named_value<int, decltype("c06"_)>,
+    nvt::named_value<double, decltype("c07"_)>,
+    nvt::named_value<double, decltype("c08"_)>,
+    nvt::named_value<double, decltype("px"_)>,
+    nvt::named_value<std::uint64_t, decltype("c09"_)>,
+    nvt::named_value<int, decltype("c10"_)>,
+    nvt::named_value<double, decltype("c11"_)>,
+    nvt::named_value<double, decltype("c12"_)>,
+    nvt::named_value<std::uint64_t, decltype("c13"_)>,
+    nvt::named_value<int, decltype("c14"_)>,
+    nvt::named_value<double, decltype("c15"_)>,
+    nvt::named_value<double, decltype("c16"_)>,
+    nvt::named_value<std::uint64_t, decltype("c17"_)>,
+    nvt::named_value<int, decltype("qty"_)>,
+    nvt::named_value<int, decltype("c18"_)>,
+    nvt::named_value<double, decltype("c19"_)>,
+    nvt::named_value<double, decltype("c20"_)>,
+    nvt::named_value<std::uint64_t, decltype("c21"_)>,
+    nvt::named_value<int, decltype("c22"_)>,
+    nvt::named_value<double, decltype("c23"_)>,
+    nvt::named_value<double, decltype("c24"_)>,
+    nvt::named_value<std::uint64_t, decltype("c25"_)>,
+    nvt::named_value<int, decltype("c26"_)>,
+    nvt::named_value<char, decltype("side"_)>,
+    nvt::named_value<double, decltype("c27"_)>,
+    nvt::named_value<double, decltype("c28"_)>,
+    nvt::named_value<std::uint64_t, decltype("c29"_)>,
+    nvt::named_value<int, decltype("c30"_)>,
+    nvt::named_value<double, decltype("c31"_)>,
+    nvt::named_value<double, decltype("c32"_)>,
+    nvt::named_value<std::uint64_t, decltype("c33"_)>,
+    nvt::named_value<int, decltype("c34"_)>,
+    nvt::named_value<double, decltype("c35"_)>,
+    nvt::named_value<std::uint64_t, decltype("id"_)>,
+    nvt::named_value<double, decltype("c36"_)>,
+    nvt::named_value<std::uint64_t, decltype("c37"_)>,
+    nvt::named_value<int, decltype("c38"_)>,
+    nvt::named_value<double, decltype("c39"_)>,
+    nvt::named_value<double, decltype("c40"_)>,
+    nvt::named_value<std::uint64_t, decltype("c41"_)>,
+    nvt::named_value<int, decltype("c42"_)>,
+    nvt::named_value<double, decltype("c43"_)>,
+    nvt::named_value<double, decltype("c44"_)>,
+    nvt::named_value<std::uint32_t, decltype("state"_)>,
+    nvt::named_value<std::uint64_t, decltype("c45"_)>,
+    nvt::named_value<int, decltype("c46"_)>,
+    nvt::named_value<double, decltype("c47"_)>,
+    nvt::named_value<double, decltype("c48"_)>,
+    nvt::named_value<std::uint64_t, decltype("c49"_)>,
+    nvt::named_value<int, decltype("c50"_)>,
+    nvt::named_value<double, decltype("c51"_)>,
+    nvt::named_value<double, decltype("c52"_)>,
+    nvt::named_value<std::uint64_t, decltype("c53"_)>,
+    nvt::named_value<double, decltype("filled"_)>>;
+using split_order_t = nvt::split_for_t<order_t>;
+
+template<typename Record>
+void scan(const char* label, std::size_t n) {
+    std::vector<Record> records(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        records[i]["px"_] = double(i % 1000) * 0.25;
+        records[i]["qty"_] = int(i % 100);
+        records[i]["side"_] = (i & 1) ? 'B' : 'S';
+        records[i]["state"_] = std::uint32_t(i % 3);
+    }
+    double total = 0;
+    constexpr int reps = 10;
+    const auto start = std::chrono::steady_clock::now();
+    for (int rep = 0; rep < reps; ++rep)
+        for (const auto& r : records)
+            if (r["state"_].get() != 2 && r["side"_].get() == 'B')
+                total += r["px"_].get() * r["qty"_].get() -
+                         r["filled"_].get() + double(r["id"_].get());
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::cout << label << ": sizeof " << sizeof(Record) << ", "
+              << double(ns) / double(reps * n) << " ns/record"
+              << " (total " << total << ")\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                   : std::size_t(1) << 20;
+    std::cout << "hot block " << split_order_t::hot_size
+              << " bytes, cold block " << split_order_t::cold_size
+              << " bytes\n";
+    scan<order_t>("named_tuple", n);
+    scan<split_order_t>("split_tuple", n);
+    return 0;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// thread_slots<T> - one T per thread for each owning object, e.g. the ring
+// of a logger or the shard of a metrics schema, written by its thread only:
+//
+//   nvt::thread_slots<shard> _shards;
+//   _shards.local().add(1);                         // this thread's shard
+//   _shards.for_each([](const shard& s) { ... });   // all the shards
+//
+// local() creates the T of the calling thread on its first call; later calls
+// find it in a thread local cache of the last used thread_slots, then in a
+// thread local list. When a thread exits, its slots are released and handed,
+// with their contents, to the next threads calling local(): there are as
+// many T as threads running at the same time, not as threads ever created.
+// The T are destroyed with the thread_slots, which may be destroyed before
+// the threads that used it.
+
+namespace nvtuple_ns {
+
+template<typename T>
+class thread_slots {
+    struct slot {
+        template<typename... A>
+        explicit slot(A&&... args) : value(std::forward<A>(args)...) {}
+        T value;
+        bool in_use{true};  // guarded by the registry mutex
+    };
+
+    struct registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<slot>> slots;
+    };
+
+    // the slot of a thread in one thread_slots, released at thread exit
+    struct entry {
+        std::uint64_t id;
+        std::weak_ptr<registry> owner;
+        slot* s;
+    };
+
+    // the thread local state of a thread for all the thread_slots<T>: the
+    // last used slot, and the slots of the thread released at its exit
+    struct thread_entries {
+        std::uint64_t last_id{0};
+        slot* last{nullptr};
+        std::vector<entry> entries;
+        ~thread_entries() {
+            for (auto& e : entries)
+                if (auto r = e.owner.lock()) {
+                    std::lock_guard<std::mutex> lock(r->mutex);
+                    e.s->in_use = false;
+                }
+        }
+    };
+
+   public:
+    thread_slots() : _id(next_id()), _registry(std::make_shared<registry>()) {}
+
+    thread_slots(const thread_slots&) = delete;
+    thread_slots& operator=(const thread_slots&) = delete;
+
+    // the T of the calling thread, constructed from args when a new one is
+    // needed
+    template<typename... A>
+    T& local(A&&... args) {
+        thread_entries& mine = this_thread();
+        if (mine.last_id == _id) return mine.last->value;
+        for (auto& e : mine.entries)
+            if (e.id == _id) {
+                mine.last_id = e.id;
+                mine.last = e.s;
+                return e.s->value;
+            }
+        // forget the slots of destroyed owners
+        std::erase_if(mine.entries,
+                      [](const entry& e) { return e.owner.expired(); });
+        slot* s = acquire(std::forward<A>(args)...);
+        mine.entries.push_back({_id, _registry, s});
+        mine.last_id = _id;
+        mine.last = s;
+        return s->value;
+    }
+
+    // f(T&) for every T, in use or released, under the registry lock
+    template<typename F>
+    void for_each(F&& f) {
+        std::lock_guard<std::mutex> lock(_registry->mutex);
+        for (auto& s : _registry->slots) f(s->value);
+    }
+
+    template<typename F>
+    void for_each(F&& f) const {
+        std::lock_guard<std::mutex> lock(_registry->mutex);
+        for (auto& s : _registry->slots) f(std::as_const(s->value));
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(_registry->mutex);
+        return _registry->slots.size();
+    }
+
+   private:
+    // not in local(), whose instantiations for other argument types would
+    // each have their own thread local state
+    static thread_entries& this_thread() noexcept {
+        thread_local thread_entries mine;
+        return mine;
+    }
+
+    static std::uint64_t next_id() noexcept {
+        static std::atomic<std::uint64_t> id{0};
+        return ++id;
+    }
+
+    // a released slot, or a new one; the mutex orders the writes of the
+    // thread that released the slot before those of its next thread
+    template<typename... A>
+    slot* acquire(A&&... args) {
+        std::lock_guard<std::mutex> lock(_registry->mutex);
+        for (auto& s : _registry->slots)
+            if (!s->in_use) {
+                s->in_use = true;
+                return s.get();
+            }
+        _registry->slots.push_back(
+            std::make_unique<slot>(std::forward<A>(args)...));
+        return _registry->slots.back().get();
+    }
+
+    std::uint64_t _id;
+    std::shared_ptr<registry> _registry;
+};
+
+}  // namespace nvtuple_ns